@@ -0,0 +1,208 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InstancedInteractableComponent.h"
+#include "InteractableDefinition.h"
+#include "InteractionSubsystem.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractionLog.h"
+#include "InteractionMemory.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Actor.h"
+
+UInstancedInteractableComponent::UInstancedInteractableComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UInstancedInteractableComponent::RegisterInstances()
+{
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	if (!Subsystem || !InstancedMesh || !Definition)
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("Subsystem, InstancedMesh or Definition in RegisterInstances() is nullptr. Owner name: %s"), *GetNameSafe(GetOwner()));
+		return;
+	}
+
+	const int32 NumInstances = InstancedMesh->GetInstanceCount();
+	const FVector BoundsOrigin = InstancedMesh->GetStaticMesh() ? InstancedMesh->GetStaticMesh()->GetBounds().Origin
+		: FVector::ZeroVector;
+
+	InstanceHandles.SetNum(NumInstances);
+
+	for (int32 InstanceIndex = 0; InstanceIndex < NumInstances; ++InstanceIndex)
+	{
+		FTransform InstanceTransform;
+		InstancedMesh->GetInstanceTransform(InstanceIndex, InstanceTransform, true);
+
+		// Centre of the instance so reachability traces end on the instance itself
+		InstanceHandles[InstanceIndex] = Subsystem->AddInstancedLightweightInteractable(Definition,
+			InstanceTransform.TransformPosition(BoundsOrigin), InstancedMesh, InstanceIndex);
+	}
+}
+
+void UInstancedInteractableComponent::UnregisterInstances()
+{
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		for (const FInteractionHandle& Handle : InstanceHandles)
+		{
+			Subsystem->RemoveLightweightInteractable(Handle);
+		}
+	}
+
+	InstanceHandles.Reset();
+}
+
+void UInstancedInteractableComponent::RefreshInstances()
+{
+	UnregisterInstances();
+	RegisterInstances();
+}
+
+int32 UInstancedInteractableComponent::FindInstanceIndex(const FInteractionHandle& Handle) const
+{
+	const UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+	int32 InstanceIndex = INDEX_NONE;
+
+	if (!Subsystem || Subsystem->GetLightweightInstance(Handle, InstanceIndex) != InstancedMesh)
+	{
+		return INDEX_NONE;
+	}
+
+	return InstanceHandles.IsValidIndex(InstanceIndex) && InstanceHandles[InstanceIndex] == Handle
+		? InstanceIndex : INDEX_NONE;
+}
+
+void UInstancedInteractableComponent::OnLightweightInteracted(FInteractionHandle Handle,
+	UPlayerInteractionComponent* Player)
+{
+	const int32 InstanceIndex = FindInstanceIndex(Handle);
+
+	if (InstanceIndex != INDEX_NONE && OnInstanceInteractedDelegate.IsBound())
+	{
+		OnInstanceInteractedDelegate.Broadcast(InstanceIndex, Player ? Player->GetOwner() : nullptr);
+	}
+}
+
+void UInstancedInteractableComponent::OnLightweightUsed(FInteractionHandle Handle)
+{
+	if (!bRemoveInstanceAfterUsage)
+	{
+		return;
+	}
+
+	const int32 InstanceIndex = FindInstanceIndex(Handle);
+
+	if (InstanceIndex != INDEX_NONE)
+	{
+		RemoveInstance(InstanceIndex);
+	}
+}
+
+void UInstancedInteractableComponent::RemoveInstance(int32 InstanceIndex)
+{
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	if (!Subsystem || !InstancedMesh)
+	{
+		return;
+	}
+
+	Subsystem->RemoveLightweightInteractable(InstanceHandles[InstanceIndex]);
+
+	const int32 LastIndex = InstanceHandles.Num() - 1;
+
+	// HISM moves the last instance into the removed slot, ISM shifts every following instance down
+	if (InstancedMesh->IsA<UHierarchicalInstancedStaticMeshComponent>())
+	{
+		InstancedMesh->RemoveInstance(InstanceIndex);
+		InstanceHandles.RemoveAtSwap(InstanceIndex, 1, false);
+
+		if (InstanceIndex != LastIndex)
+		{
+			Subsystem->SetLightweightInstanceIndex(InstanceHandles[InstanceIndex], InstanceIndex);
+		}
+	}
+	else
+	{
+		InstancedMesh->RemoveInstance(InstanceIndex);
+		InstanceHandles.RemoveAt(InstanceIndex, 1, false);
+
+		for (int32 Index = InstanceIndex; Index < InstanceHandles.Num(); ++Index)
+		{
+			Subsystem->SetLightweightInstanceIndex(InstanceHandles[Index], Index);
+		}
+	}
+}
+
+void UInstancedInteractableComponent::SetInstanceEnabled(int32 InstanceIndex, bool bEnabled)
+{
+	if (!InstanceHandles.IsValidIndex(InstanceIndex))
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("InstanceIndex %d passed to SetInstanceEnabled() is invalid."), InstanceIndex);
+		return;
+	}
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->SetLightweightInteractableEnabled(InstanceHandles[InstanceIndex], bEnabled);
+	}
+}
+
+bool UInstancedInteractableComponent::IsInstanceUsable(int32 InstanceIndex) const
+{
+	const UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	return Subsystem && InstanceHandles.IsValidIndex(InstanceIndex)
+		&& Subsystem->IsLightweightInteractableUsable(InstanceHandles[InstanceIndex]);
+}
+
+FInteractionHandle UInstancedInteractableComponent::GetInstanceHandle(int32 InstanceIndex) const
+{
+	return InstanceHandles.IsValidIndex(InstanceIndex) ? InstanceHandles[InstanceIndex] : FInteractionHandle();
+}
+
+void UInstancedInteractableComponent::AddMemoryUsage(FInteractionMemoryReport& Report) const
+{
+	Report.AddObject(Report.Components, this);
+	Report.Caches.Add(1, InstanceHandles.GetAllocatedSize());
+}
+
+void UInstancedInteractableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!InstancedMesh && GetOwner())
+	{
+		InstancedMesh = GetOwner()->FindComponentByClass<UInstancedStaticMeshComponent>();
+	}
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		InteractedDelegateHandle = Subsystem->OnLightweightInteracted.AddUObject(this,
+			&UInstancedInteractableComponent::OnLightweightInteracted);
+		UsedDelegateHandle = Subsystem->OnLightweightUsed.AddUObject(this,
+			&UInstancedInteractableComponent::OnLightweightUsed);
+	}
+
+	RegisterInstances();
+}
+
+void UInstancedInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterInstances();
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->OnLightweightInteracted.Remove(InteractedDelegateHandle);
+		Subsystem->OnLightweightUsed.Remove(UsedDelegateHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
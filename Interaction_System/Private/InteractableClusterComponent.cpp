@@ -0,0 +1,323 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractableClusterComponent.h"
+#include "InteractableComponent.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractionSubsystem.h"
+#include "InteractionStats.h"
+#include "InteractionLog.h"
+#include "InteractionMemory.h"
+
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "TimerManager.h"
+
+UInteractableClusterComponent::UInteractableClusterComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+	SetGenerateOverlapEvents(true);
+}
+
+void UInteractableClusterComponent::GatherMembers()
+{
+	if (!GetOwner())
+	{
+		return;
+	}
+
+	TArray<AActor*> Actors;
+	GetOwner()->GetAttachedActors(Actors);
+	Actors.Add(GetOwner());
+
+	for (const AActor* Actor : Actors)
+	{
+		TInlineComponentArray<UInteractableComponent*> Interactables(Actor);
+
+		for (UInteractableComponent* Interactable : Interactables)
+		{
+			AddMember(Interactable);
+		}
+	}
+}
+
+void UInteractableClusterComponent::FitToMembers()
+{
+	const FVector Center = GetComponentLocation();
+	float Radius = GetScaledSphereRadius();
+
+	for (const auto& Member : Members)
+	{
+		if (Member.IsValid())
+		{
+			const float MemberReach = Member->SphereComponent ? Member->SphereComponent->GetScaledSphereRadius()
+				: Member->GetSettings().MaximumDistanceToPlayer;
+
+			Radius = FMath::Max(Radius, FVector::Dist(Center, Member->GetComponentLocation()) + MemberReach);
+		}
+	}
+
+	SetSphereRadius(Radius / FMath::Max(GetShapeScale(), KINDA_SMALL_NUMBER));
+}
+
+void UInteractableClusterComponent::AddMember(UInteractableComponent* Member)
+{
+	if (!Member)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Member passed to AddMember() is nullptr."));
+		return;
+	}
+
+	if (Members.Contains(Member))
+	{
+		return;
+	}
+
+	Members.Add(Member);
+	Member->JoinCluster(this);
+}
+
+void UInteractableClusterComponent::RemoveMember(UInteractableComponent* Member)
+{
+	if (!Member || !Members.Contains(Member))
+	{
+		return;
+	}
+
+	for (const auto& Player : PlayersInRange)
+	{
+		if (Player.IsValid())
+		{
+			Player->RemoveInteractable(Member);
+		}
+	}
+
+	Members.RemoveSingleSwap(Member, false);
+	Member->LeaveCluster();
+}
+
+bool UInteractableClusterComponent::IsReachableBy(const AActor* Player) const
+{
+	if (!Player || !GetWorld())
+	{
+		return false;
+	}
+
+	FClusterReachability* Entry = ReachabilityCache.FindByPredicate([Player](const FClusterReachability& Cached)
+	{
+		return Cached.Player.Get() == Player;
+	});
+
+	if (Entry && Entry->Frame == GFrameCounter)
+	{
+		return Entry->bReachable;
+	}
+
+	if (!Entry)
+	{
+		ReachabilityCache.RemoveAll([](const FClusterReachability& Cached)
+		{
+			return !Cached.Player.IsValid();
+		});
+
+		Entry = &ReachabilityCache.AddDefaulted_GetRef();
+		Entry->Player = Player;
+	}
+
+	FCollisionQueryParams CollisionParams;
+	CollisionParams.AddIgnoredActor(GetOwner());
+
+	for (const auto& Member : Members)
+	{
+		if (Member.IsValid())
+		{
+			CollisionParams.AddIgnoredActor(Member->GetOwner());
+		}
+	}
+
+	FHitResult OutHit;
+
+	INTERACTION_INC_TRACES();
+
+	Entry->bReachable = !GetWorld()->LineTraceSingleByChannel(OutHit, GetComponentLocation(),
+		Player->GetActorLocation(), ECC_Visibility, CollisionParams) || OutHit.GetActor() == Player;
+	Entry->Frame = GFrameCounter;
+
+	return Entry->bReachable;
+}
+
+void UInteractableClusterComponent::AddMemoryUsage(FInteractionMemoryReport& Report) const
+{
+	Report.AddObject(Report.Components, this);
+	Report.Subscriptions.Add(0, Members.GetAllocatedSize() + PlayersInRange.GetAllocatedSize());
+	Report.Caches.Add(1, ReachabilityCache.GetAllocatedSize());
+}
+
+void UInteractableClusterComponent::UpdatePlayer(UPlayerInteractionComponent* Player)
+{
+	const AActor* PlayerActor = Player ? Player->GetOwner() : nullptr;
+
+	if (!PlayerActor)
+	{
+		return;
+	}
+
+	const FVector PlayerLocation = PlayerActor->GetActorLocation();
+	const float PlayerRadius = PlayerActor->GetSimpleCollisionRadius();
+
+	for (int32 Index = Members.Num() - 1; Index >= 0; --Index)
+	{
+		UInteractableComponent* Member = Members[Index].Get();
+
+		if (!Member)
+		{
+			Members.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const float Reach = (Member->SphereComponent ? Member->SphereComponent->GetScaledSphereRadius()
+			: Member->GetSettings().MaximumDistanceToPlayer) + PlayerRadius;
+
+		if (FVector::DistSquared(PlayerLocation, Member->GetComponentLocation()) <= Reach * Reach)
+		{
+			Player->AddInteractable(Member);
+		}
+		else
+		{
+			Player->RemoveInteractable(Member);
+		}
+	}
+}
+
+void UInteractableClusterComponent::UpdateMembers()
+{
+	INTERACTION_BENCHMARK_SCOPE();
+
+	for (int32 Index = PlayersInRange.Num() - 1; Index >= 0; --Index)
+	{
+		if (UPlayerInteractionComponent* Player = PlayersInRange[Index].Get())
+		{
+			UpdatePlayer(Player);
+		}
+		else
+		{
+			PlayersInRange.RemoveAtSwap(Index, 1, false);
+		}
+	}
+
+	if (!PlayersInRange.Num() && GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(MemberUpdateTimerHandle);
+	}
+}
+
+void UInteractableClusterComponent::OnClusterOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	INTERACTION_BENCHMARK_SCOPE();
+
+	const APawn* Pawn = Cast<APawn>(OtherActor);
+
+	if (!Pawn || !Pawn->IsLocallyControlled())
+	{
+		return;
+	}
+
+	UPlayerInteractionComponent* Player = UInteractionSubsystem::FindPlayerInteractionComponent(OtherActor);
+
+	if (!Player || PlayersInRange.Contains(Player))
+	{
+		return;
+	}
+
+	PlayersInRange.Add(Player);
+	UpdatePlayer(Player);
+
+	if (GetWorld() && !GetWorld()->GetTimerManager().IsTimerActive(MemberUpdateTimerHandle))
+	{
+		GetWorld()->GetTimerManager().SetTimer(MemberUpdateTimerHandle, this,
+			&UInteractableClusterComponent::UpdateMembers, MemberUpdateInterval, true);
+	}
+}
+
+void UInteractableClusterComponent::OnClusterOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	INTERACTION_BENCHMARK_SCOPE();
+
+	UPlayerInteractionComponent* Player = UInteractionSubsystem::FindPlayerInteractionComponent(OtherActor);
+
+	if (!Player || !PlayersInRange.Contains(Player))
+	{
+		return;
+	}
+
+	for (const auto& Member : Members)
+	{
+		if (Member.IsValid())
+		{
+			Player->RemoveInteractable(Member.Get());
+		}
+	}
+
+	PlayersInRange.RemoveSingleSwap(Player, false);
+}
+
+void UInteractableClusterComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bGatherMembersOnBeginPlay)
+	{
+		GatherMembers();
+	}
+
+	if (bFitToMembers)
+	{
+		FitToMembers();
+	}
+
+	// Nobody is locally controlled on a dedicated server, members are tracked by the spatial grid there
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		SetGenerateOverlapEvents(false);
+		return;
+	}
+
+	OnComponentBeginOverlap.AddDynamic(this, &UInteractableClusterComponent::OnClusterOverlapBegin);
+	OnComponentEndOverlap.AddDynamic(this, &UInteractableClusterComponent::OnClusterOverlapEnd);
+
+	// Players already inside the sphere don't get a begin overlap
+	TArray<AActor*> OverlappingActors;
+	GetOverlappingActors(OverlappingActors, APawn::StaticClass());
+
+	for (AActor* Actor : OverlappingActors)
+	{
+		OnClusterOverlapBegin(this, Actor, nullptr, INDEX_NONE, false, FHitResult());
+	}
+}
+
+void UInteractableClusterComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(MemberUpdateTimerHandle);
+	}
+
+	// Copy since RemoveMember modifies Members
+	const TArray<TWeakObjectPtr<UInteractableComponent>> ClusterMembers = Members;
+
+	for (const auto& Member : ClusterMembers)
+	{
+		if (Member.IsValid())
+		{
+			RemoveMember(Member.Get());
+		}
+	}
+
+	PlayersInRange.Reset();
+	ReachabilityCache.Reset();
+
+	Super::EndPlay(EndPlayReason);
+}
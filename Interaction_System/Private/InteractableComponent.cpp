@@ -4,6 +4,12 @@
 #include "NameWidget.h"
 #include "InteractionWidgetOnInteractable.h"
 #include "InteractionLog.h"
+#include "InteractionSubsystem.h"
+#include "InteractableDefinition.h"
+#include "InteractableClusterComponent.h"
+#include "InteractionStats.h"
+#include "InteractionTrace.h"
+#include "InteractionMemory.h"
 
 #include "GameFramework/Actor.h"
 #include "GameFramework/Character.h"
@@ -19,12 +25,22 @@
 
 #include "Net/UnrealNetwork.h"
 
+DECLARE_CYCLE_STAT(TEXT("Interactable Tick"), STAT_InteractableTick, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("CanInteract"), STAT_InteractableCanInteract, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("DrawDebugStrings"), STAT_InteractableDrawDebugStrings, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("RotateWidgetsToPlayer"), STAT_InteractableRotateWidgets, STATGROUP_InteractionSystem);
+
 UInteractableComponent::UInteractableComponent()
 	: bCanBroadcastCanInteract(true), InteractionWidgetOnInteractableUsable(false), InteractionMarkerUsable(false),
 	NameWidgetUsable(false), CanShowInteractionMarker(true)
 {
+	INTERACTION_LLM_SCOPE(Components);
+
 	PrimaryComponentTick.bCanEverTick = true;
 
+	// Reads the selection of its players, evaluated by UInteractionSubsystem earlier in the same group
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
 	SphereComponent = CreateDefaultSubobject<USphereComponent>(FName("InteractionCollision"));
 	InteractionMarker = CreateDefaultSubobject<UWidgetComponent>(TEXT("InteractableMarker"));
 	InteractionWidgetOnInteractable = CreateDefaultSubobject<UWidgetComponent>(TEXT("InteractionWidgetOnInteractable"));
@@ -53,12 +69,12 @@ void UInteractableComponent::OnOverlapBegin(
 	const FHitResult& SweepResult
 )
 {
+	INTERACTION_BENCHMARK_SCOPE();
+
 	if (OtherActor && OtherActor != GetOwner() && OtherComp &&
 		Cast<APawn>(OtherActor) && Cast<APawn>(OtherActor)->IsLocallyControlled())
 	{
-		if (UPlayerInteractionComponent* PIC = OtherActor->
-			FindComponentByClass<UPlayerInteractionComponent>()
-		)
+		if (UPlayerInteractionComponent* PIC = UInteractionSubsystem::FindPlayerInteractionComponent(OtherActor))
 		{
 			PIC->AddActorToInteract(GetOwner());
 		}
@@ -72,12 +88,12 @@ void UInteractableComponent::OnOverlapEnd(
 	int32 OtherBodyIndex
 )
 {
+	INTERACTION_BENCHMARK_SCOPE();
+
 	if (OtherActor && OtherActor != GetOwner() && OtherComp &&
 		Cast<APawn>(OtherActor) && Cast<APawn>(OtherActor)->IsLocallyControlled())
 	{
-		if (UPlayerInteractionComponent* PIC = OtherActor->
-			FindComponentByClass<UPlayerInteractionComponent>()
-		)
+		if (UPlayerInteractionComponent* PIC = UInteractionSubsystem::FindPlayerInteractionComponent(OtherActor))
 		{
 			PIC->RemoveActorToInteract(GetOwner());
 		}
@@ -93,6 +109,9 @@ void UInteractableComponent::Interact(UPlayerInteractionComponent* PIC)
 		return;
 	}
 
+	TRACE_INTERACTION_SCOPE(Interaction_Interact);
+	TRACE_INTERACTION_EVENT(Interact, this, PIC);
+
 	if (InteractDelegate.IsBound())
 	{
 		InteractDelegate.Broadcast(PIC->GetOwner());
@@ -108,23 +127,30 @@ void UInteractableComponent::UnsubscribeFromComponent(AActor* Player)
 		return;
 	}
 
-	if (!SubscribedPlayers.Contains(Player))
+	UPlayerInteractionComponent* PlayerComponent = UInteractionSubsystem::FindPlayerInteractionComponent(Player);
+
+	const int32 Slot = PlayerComponent ? FindSubscriberSlot(PlayerComponent) : INDEX_NONE;
+
+	if (Slot == INDEX_NONE)
 	{
 		UE_LOG(InteractionSystem, Warning,
 			TEXT("Player passed to UnsubscribeFromComponent() is not cached inside subscribed players."));
 		return;
 	}
 
-	SubscribedPlayers.Remove(Player);
+	// Removed by slot, the shift keeps the indexed players ordered so the slots stay valid
+	PlayerComponents.RemoveAt(Slot, 1, false);
 
-	AmountOfSubscribedPlayers--;
+	TRACE_INTERACTION_EVENT(Unsubscribe, this, PlayerComponent);
 
-	if (OnUnsubscribedDelegate.IsBound())
+	if (PlayerComponent->GetInteractionIndex() != INDEX_NONE)
 	{
-		OnUnsubscribedDelegate.Broadcast(Player);
+		SubscribedPlayerMask &= ~(1ull << PlayerComponent->GetInteractionIndex());
 	}
 
-	if (SubscribedPlayers.Num() <= 0)
+	UInteractionSubsystem::BroadcastEvent(EInteractionEvent::Unsubscribed, this, PlayerComponent);
+
+	if (PlayerComponents.Num() <= 0)
 	{
 		SetComponentTickEnabled(false);
 	}
@@ -143,43 +169,44 @@ void UInteractableComponent::SubscribeToComponent(AActor* Player, bool Currently
 		return;
 	}
 
-	if(SubscribedPlayers.Contains(Player))
-	{
-		return;
-	}
-
-	SubscribedPlayers.Add(Player);
-	++AmountOfSubscribedPlayers;
+	INTERACTION_LLM_SCOPE(Subscriptions);
 
-	UPlayerInteractionComponent* Temp = SubscribedPlayers[AmountOfSubscribedPlayers - 1]
-		->FindComponentByClass<UPlayerInteractionComponent>();
+	UPlayerInteractionComponent* Temp = UInteractionSubsystem::FindPlayerInteractionComponent(Player);
 
 	if (!Temp)
 	{
-		SubscribedPlayers.Remove(Player);
-		--AmountOfSubscribedPlayers;
-
 		UE_LOG(InteractionSystem, Warning,
 			TEXT("Tried to subscribe to a player %s with invalid interaction component or without one in SubscribeToComponent()."), *GetNameSafe(Player));
 		return;
 	}
 
-	if (CurrentlySelected && Temp->CanSelectOnlyOneInteractable)
+	if (IsSubscribed(Temp))
 	{
-		if (OnSelectedDelegate.IsBound())
-		{
-			OnSelectedDelegate.Broadcast(Player);
-		}
+		return;
 	}
 
-	SetComponentTickEnabled(true);
+	TRACE_INTERACTION_EVENT(Subscribe, this, Temp);
 
-	PlayerComponents.Add(Temp);
+	if (Temp->GetInteractionIndex() != INDEX_NONE)
+	{
+		const uint64 Bit = 1ull << Temp->GetInteractionIndex();
 
-	if (OnSubscribedDelegate.IsBound())
+		PlayerComponents.Insert(Temp, FMath::CountBits(SubscribedPlayerMask & (Bit - 1)));
+		SubscribedPlayerMask |= Bit;
+	}
+	else
 	{
-		OnSubscribedDelegate.Broadcast(Player);
+		PlayerComponents.Add(Temp);
 	}
+
+	if (CurrentlySelected && Temp->CanSelectOnlyOneInteractable)
+	{
+		UInteractionSubsystem::BroadcastEvent(EInteractionEvent::Selected, this, Temp);
+	}
+
+	SetComponentTickEnabled(true);
+
+	UInteractionSubsystem::BroadcastEvent(EInteractionEvent::Subscribed, this, Temp);
 }
 
 bool UInteractableComponent::IsSubscribed(const UPlayerInteractionComponent* PlayerComponent) const
@@ -191,11 +218,50 @@ bool UInteractableComponent::IsSubscribed(const UPlayerInteractionComponent* Pla
 		return false;
 	}
 
-	return PlayerComponents.Contains(PlayerComponent);
+	return FindSubscriberSlot(PlayerComponent) != INDEX_NONE;
+}
+
+int32 UInteractableComponent::FindSubscriberSlot(const UPlayerInteractionComponent* PlayerComponent) const
+{
+	if (PlayerComponent->GetInteractionIndex() != INDEX_NONE)
+	{
+		const uint64 Bit = 1ull << PlayerComponent->GetInteractionIndex();
+
+		return (SubscribedPlayerMask & Bit) ? FMath::CountBits(SubscribedPlayerMask & (Bit - 1)) : INDEX_NONE;
+	}
+
+	// Players beyond the 64 indexed ones fall back to a linear search after the indexed ones
+	for (int32 Slot = FMath::CountBits(SubscribedPlayerMask); Slot < PlayerComponents.Num(); ++Slot)
+	{
+		if (PlayerComponents[Slot] == PlayerComponent)
+		{
+			return Slot;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+TArray<AActor*> UInteractableComponent::GetSubscribedPlayers() const
+{
+	TArray<AActor*> Players;
+	Players.Reserve(PlayerComponents.Num());
+
+	for (const auto& PlayerComponent : PlayerComponents)
+	{
+		if (PlayerComponent.IsValid() && PlayerComponent->GetOwner())
+		{
+			Players.Add(PlayerComponent->GetOwner());
+		}
+	}
+
+	return Players;
 }
 
 bool UInteractableComponent::CanInteract(const AActor* Player)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractableCanInteract);
+
 	if (!Player)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -203,180 +269,258 @@ bool UInteractableComponent::CanInteract(const AActor* Player)
 		return false;
 	}
 
-	if (InteractableStructure.bDisabled)
+	FInteractionEvaluationView View;
+
+	if (const UPlayerInteractionComponent* PlayerInteractionComponent =
+		UInteractionSubsystem::FindPlayerInteractionComponent(Player))
 	{
+		PlayerInteractionComponent->GatherEvaluationView(View,
+			GetSettings().bDoesAngleMatter && !bDisabled);
+	}
+	else
+	{
+		View.Player = Player;
+		View.PawnLocation = Player->GetActorLocation();
+	}
+
+	FInteractionEvaluationJob Job;
+
+	GatherEvaluation(View, 0, false, Job);
+	Job.Evaluate(GetWorld(), View);
+	ApplyEvaluation(Job, View);
+
+	return Job.Evaluation.Result == EInteractionEvaluationResult::Usable;
+}
+
+void UInteractableComponent::GatherEvaluation(const FInteractionEvaluationView& View, int32 ViewIndex,
+	bool bAlwaysCheckReachability, FInteractionEvaluationJob& OutJob) const
+{
+	const FInteractable& Settings = GetSettings();
+
+	OutJob.Interactable = this;
+	OutJob.InteractableOwner = GetOwner();
+	OutJob.ViewIndex = ViewIndex;
+	OutJob.Location = GetComponentLocation();
+	OutJob.MaximumDistance = Settings.MaximumDistanceToPlayer;
+	OutJob.AngleMargin = Settings.PlayersAngleMarginOfErrorToInteractable;
+	OutJob.bDisabled = bDisabled;
+	OutJob.bSubscribed = GetOwner() && PlayerComponents.Num() > 0;
+	OutJob.bDistanceMatters = Settings.bDoesDistanceToPlayerMatter;
+	OutJob.bHasToBeReachable = Settings.bHasToBeReacheable;
+	OutJob.bAngleMatters = Settings.bDoesAngleMatter;
+	OutJob.bAlwaysCheckReachability = bAlwaysCheckReachability;
+	OutJob.Evaluation.Player = View.Player;
+
+	if (!OutJob.bHasToBeReachable && !bAlwaysCheckReachability)
+	{
+		return;
+	}
+
+	// The cluster caches its traces per frame, it is only queried from the game thread
+	if (Cluster.IsValid())
+	{
+		OutJob.bReachable = Cluster->IsReachableBy(View.Player);
+		OutJob.bReachabilityResolved = true;
+	}
+	else if (!OutJob.bSubscribed || !GetWorld())
+	{
+		OutJob.bReachable = false;
+		OutJob.bReachabilityResolved = true;
+	}
+}
+
+void UInteractableComponent::ApplyEvaluation(const FInteractionEvaluationJob& Job,
+	const FInteractionEvaluationView& View)
+{
+	LastEvaluation = Job.Evaluation;
+
+	if (Job.bReachabilityTraced)
+	{
+		DrawReachabilityDebugLine(View.PawnLocation);
+	}
+
+	if (!Job.bAngleMatters)
+	{
+		return;
+	}
+
+	if (!View.bHasPlayerComponent && Job.Evaluation.Result == EInteractionEvaluationResult::NotEvaluated)
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("Tried to check angle to player but PlayerInteractionComponent in CanInteract() is nullptr."));
+	}
+	else if (Job.Evaluation.bAngleChecked && View.AngleFailure)
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("Tried to check Check Angle To Player but %s in GatherEvaluationView() is nullptr."),
+			View.AngleFailure);
+	}
+}
+
+bool UInteractableComponent::CanInteractFromSnapshot(const UPlayerInteractionComponent* PlayerComponent,
+	const FInteractionPlayerSnapshot& Snapshot) const
+{
+	if (!PlayerComponent)
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("Tried to check if player can interact but PlayerComponent passed to CanInteractFromSnapshot() is nullptr."));
 		return false;
 	}
 
-	if (InteractableStructure.bDoesDistanceToPlayerMatter)
+	if (bDisabled)
 	{
-		if (CheckDistanceToPlayer(Player) > InteractableStructure.MaximumDistanceToPlayer)
+		return false;
+	}
+
+	if (GetSettings().bDoesDistanceToPlayerMatter)
+	{
+		if (FVector::Dist(GetComponentLocation(), Snapshot.PawnLocation) > GetSettings().MaximumDistanceToPlayer)
 		{
 			return false;
 		}
 	}
 
-	if (InteractableStructure.bHasToBeReacheable)
+	if (GetSettings().bHasToBeReacheable)
 	{
-		if (!CheckReachability(Player))
+		if (!CheckReachabilityFromLocation(PlayerComponent->GetOwner(), Snapshot.PawnLocation))
 		{
 			return false;
 		}
 	}
 
-	if (InteractableStructure.bDoesAngleMatter)
+	if (GetSettings().bDoesAngleMatter)
 	{
-		UPlayerInteractionComponent* PlayerInteractionComponent = Cast<UPlayerInteractionComponent>(
-			Player->FindComponentByClass(UPlayerInteractionComponent::StaticClass()));
+		const float Angle = CheckAngleFromSnapshot(PlayerComponent, Snapshot);
 
-		if (!PlayerInteractionComponent)
+		// Angles that couldn't be measured are ignored like in CanInteract
+		if (Angle == FAILED_Angle ? false : PlayerComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle
+			&& PlayerComponent->bIsUsingFirstPersonMode ? Angle != PlayerLooksAtInteractableValue :
+			Angle > GetSettings().PlayersAngleMarginOfErrorToInteractable)
 		{
-			UE_LOG(InteractionSystem, Warning,
-				TEXT("Tried to check angle to player but PlayerInteractionComponent in CanInteract() is nullptr."));
 			return false;
 		}
+	}
+
+	return true;
+}
+
+void UInteractableComponent::AddMemoryUsage(FInteractionMemoryReport& Report) const
+{
+	Report.AddObject(Report.Components, this);
+	Report.AddObject(Report.SphereComponents, SphereComponent);
 
-		if (CheckAngleToPlayer(Player) == FAILED_Angle ? false : PlayerInteractionComponent->
-			bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle && PlayerInteractionComponent->bIsUsingFirstPersonMode ?
-			CheckAngleToPlayer(Player) != PlayerLooksAtInteractableValue :
-			CheckAngleToPlayer(Player) > InteractableStructure.PlayersAngleMarginOfErrorToInteractable)
+	if (InlineDefinition)
+	{
+		Report.AddObject(Report.Components, InlineDefinition);
+	}
+
+	for (const UWidgetComponent* WidgetComponent : { InteractableName, InteractionMarker,
+		InteractionWidgetOnInteractable })
+	{
+		if (WidgetComponent)
 		{
-			return false;
+			Report.AddObject(Report.WidgetComponents, WidgetComponent);
+			Report.AddWidget(WidgetComponent->GetUserWidgetObject());
 		}
 	}
 
-	return true;
+	Report.Subscriptions.Add(PlayerComponents.Num(), PlayerComponents.GetAllocatedSize());
 }
 
-bool UInteractableComponent::CheckReachability(const AActor* SubscribedPlayer) const
+bool UInteractableComponent::CheckReachabilityFromLocation(const AActor* Player, const FVector& PlayerLocation) const
 {
-	if (!SubscribedPlayer)
+	if (!GetOwner() || !GetWorld())
 	{
-		UE_LOG(InteractionSystem, Warning,
-			TEXT("Tried to check reachability but SubscribedPlayer in CheckReachability() is nullptr."));
 		return false;
 	}
 
-	if (GetOwner() && SubscribedPlayers.Num() > 0 && GetWorld())
-	{
-		const FVector& InteractableLocation = GetComponentLocation();
-		const FVector& PlayerLocation = SubscribedPlayer->GetActorLocation();
+	FCollisionQueryParams CollisionParams;
+	FHitResult OutHit;
+
+	CollisionParams.AddIgnoredActor(GetOwner());
 
-		FCollisionQueryParams CollisionParams;
-		FHitResult OutHit;
+	// The player may not be at the rewound location anymore so anything not blocking the trace means reachable
+	CollisionParams.AddIgnoredActor(Player);
 
-		CollisionParams.AddIgnoredActor(GetOwner());
+	INTERACTION_INC_TRACES();
 
-		if (InteractableStructure.bDrawDebugLineForReachability)
+	while (GetWorld()->LineTraceSingleByChannel(OutHit, GetComponentLocation(), PlayerLocation,
+		ECC_Visibility, CollisionParams))
+	{
+		if (OutHit.Component.IsValid() && (OutHit.Component->IsA<USphereComponent>()
+			|| OutHit.Component->IsA<UWidgetComponent>()))
 		{
-			DrawDebugLine(GetWorld(), PlayerLocation, InteractableLocation, FColor::Green,
-				false, 0.1f, 1, 1.f);
+			CollisionParams.AddIgnoredComponent(OutHit.Component.Get());
+			INTERACTION_INC_TRACES();
 		}
-
-		do 
+		else
 		{
-			if (GetWorld()->LineTraceSingleByChannel(OutHit, InteractableLocation, PlayerLocation,
-				ECC_Visibility, CollisionParams))
-			{
-				if (OutHit.bBlockingHit)
-				{
-					if (OutHit.GetActor() && OutHit.GetActor()->
-						FindComponentByClass<UPlayerInteractionComponent>())
-					{
-						return true;
-					}
-					else if (OutHit.Component.IsValid() && (OutHit.Component->IsA<USphereComponent>()
-						|| OutHit.Component->IsA<UWidgetComponent>()))
-					{
-						CollisionParams.AddIgnoredComponent(OutHit.Component.Get());
-					}
-					else
-					{
-						return false;
-					}
-				}
-			}
-		} while (OutHit.Actor.IsValid() && (OutHit.Actor.Get()->FindComponentByClass<UInteractableComponent>()));
+			return false;
+		}
 	}
 
-	return false;
+	return true;
 }
 
-float UInteractableComponent::CheckDistanceToPlayer(const AActor* SubscribedPlayer) const
+bool UInteractableComponent::CheckReachability(const AActor* SubscribedPlayer) const
 {
 	if (!SubscribedPlayer)
 	{
 		UE_LOG(InteractionSystem, Warning,
-			TEXT("Tried to check Check Distance To Player but SubscribedPlayer in CheckDistanceToPlayer() is nullptr."));
-		return -1.f;
+			TEXT("Tried to check reachability but SubscribedPlayer in CheckReachability() is nullptr."));
+		return false;
 	}
 
-	if (GetOwner() && SubscribedPlayers.Num() > 0)
-	{
-		const FVector& InteractableLocation = GetComponentLocation();
-		const FVector& PlayerLocation = SubscribedPlayer->GetActorLocation();
+	FInteractionEvaluationView View;
+	View.Player = SubscribedPlayer;
+	View.PawnLocation = SubscribedPlayer->GetActorLocation();
 
-		return FVector::Dist(InteractableLocation, PlayerLocation);
+	FInteractionEvaluationJob Job;
+
+	GatherEvaluation(View, 0, true, Job);
+	Job.ResolveReachability(GetWorld(), View);
+
+	if (Job.bReachabilityTraced)
+	{
+		DrawReachabilityDebugLine(View.PawnLocation);
 	}
 
-	return -1.f;
+	return Job.bReachable;
 }
 
-float UInteractableComponent::CheckAngleToPlayer(const AActor* SubscribedPlayer) const
+void UInteractableComponent::DrawReachabilityDebugLine(const FVector& PlayerLocation) const
 {
-	FVector InteractableLocation = GetComponentLocation();
-
-	if (!SubscribedPlayer)
+	if (GetSettings().bDrawDebugLineForReachability)
 	{
-		UE_LOG(InteractionSystem, Warning,
-			TEXT("Tried to check Check Angle To Player but SubscribedPlayer in CheckAngleToPlayer() is nullptr."));
-		return FAILED_Angle;
+		DrawDebugLine(GetWorld(), PlayerLocation, GetComponentLocation(), FColor::Green,
+			false, 0.1f, 1, 1.f);
 	}
+}
 
-	UPlayerInteractionComponent* PlayerInteractionComponent = SubscribedPlayer
-		->FindComponentByClass<UPlayerInteractionComponent>();
-
-	if (!PlayerInteractionComponent)
+float UInteractableComponent::CheckAngleFromSnapshot(const UPlayerInteractionComponent* PlayerComponent,
+	const FInteractionPlayerSnapshot& Snapshot) const
+{
+	if (!PlayerComponent || !GetWorld())
 	{
 		UE_LOG(InteractionSystem, Warning,
-			TEXT("Tried to check Check Angle To Player but PlayerInteractionComponent in CheckAngleToPlayer() is nullptr."));
+			TEXT("Tried to check angle but PlayerComponent passed to CheckAngleFromSnapshot() is nullptr."));
 		return FAILED_Angle;
 	}
 
-	if (PlayerInteractionComponent->bIsUsingFirstPersonMode)
+	if (PlayerComponent->bIsUsingFirstPersonMode)
 	{
-		APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
-
-		if (!PlayerController)
-		{
-			UE_LOG(InteractionSystem, Warning,
-				TEXT("Tried to check Check Angle To Player but PlayerController in CheckAngleToPlayer() is nullptr."));
-			return FAILED_Angle;
-		}
-
-		if (PlayerInteractionComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle)
+		if (PlayerComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle)
 		{
 			FHitResult HitResult(ForceInit);
 
 			FCollisionQueryParams CamTraceParams = FCollisionQueryParams(FName(
 				TEXT("InteractionTrace")), true);
-			CamTraceParams.bTraceComplex = true;
-			CamTraceParams.bReturnPhysicalMaterial = true;
-			CamTraceParams.AddIgnoredActor(SubscribedPlayer);
-
-			APlayerCameraManager* PCM = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
-
-			if (!PCM)
-			{
-				UE_LOG(InteractionSystem, Warning,
-					TEXT("Tried to check Check Angle To Player but PlayerCameraManager in CheckAngleToPlayer() is nullptr."));
-				return FAILED_Angle;
-			}
+			CamTraceParams.AddIgnoredActor(PlayerComponent->GetOwner());
 
-			FVector TraceStart = PCM->GetCameraLocation();
-			FVector TraceEnd = TraceStart + PCM->GetCameraRotation().Vector() * 1000000.f;
+			const FVector TraceEnd = Snapshot.ViewLocation + Snapshot.ViewRotation.Vector() * 1000000.f;
 
-			GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_Camera,
+			INTERACTION_INC_TRACES();
+			GetWorld()->LineTraceSingleByChannel(HitResult, Snapshot.ViewLocation, TraceEnd, ECC_Camera,
 				CamTraceParams);
 
 			if (HitResult.bBlockingHit && HitResult.GetActor() && HitResult.GetActor() == GetOwner())
@@ -384,69 +528,37 @@ float UInteractableComponent::CheckAngleToPlayer(const AActor* SubscribedPlayer)
 				return PlayerLooksAtInteractableValue;
 			}
 
+			return 0.f;
 		}
-		else
-		{
-			FVector2D ComponentScreenLocation;
-			FVector2D PlayerScreenCenter;
-
-			UGameplayStatics::ProjectWorldToScreen(PlayerController, GetComponentLocation(),
-				ComponentScreenLocation);
-
-			int32 viewportX;
-			int32 viewportY;
-
-			PlayerController->GetViewportSize(viewportX, viewportY);
-
-			PlayerScreenCenter = { viewportX * 0.5f, viewportY * 0.5f };
-
-			PlayerScreenCenter.Normalize();
-			ComponentScreenLocation.Normalize();
 
-			float Dot = FVector2D::DotProduct(ComponentScreenLocation, PlayerScreenCenter);
+		// The server has no viewport, the client's view is rebuilt from the snapshot and measured the same way
+		FInteractionEvaluationView View;
 
-			return FMath::Acos(Dot) * Multiplier; //Rad to Degrees
-		}
-	}
-	else
-	{
-		UArrowComponent* Arrow = SubscribedPlayer
-			->FindComponentByClass<UArrowComponent>();
-
-		if (!Arrow)
+		if (!PlayerComponent->GatherSnapshotView(Snapshot, View))
 		{
-			UE_LOG(InteractionSystem, Warning,
-				TEXT("Tried to check Check Angle To Player but Arrow in CheckAngleToPlayer() is nullptr."));
 			return FAILED_Angle;
 		}
 
-		if (Arrow)
-		{
-			FVector PlayerForwardVector = Arrow->GetForwardVector();
-			FVector const PlayerToInteractableLocation = (InteractableLocation - SubscribedPlayer->
-				GetActorLocation()).GetSafeNormal();
-
-			PlayerForwardVector.Normalize();
-
-			float Dot = FVector::DotProduct(PlayerForwardVector, PlayerToInteractableLocation);
-
-			return FMath::Acos(Dot) * Multiplier; //Rad to Degrees
-		}
+		return FInteractionEvaluationJob::MeasureScreenAngle(GetComponentLocation(), View);
 	}
 
-	return 0.f;
+	const FVector PlayerToInteractableLocation = (GetComponentLocation() - Snapshot.PawnLocation).GetSafeNormal();
+
+	return FMath::Acos(FVector::DotProduct(Snapshot.ForwardVector, PlayerToInteractableLocation)) * Multiplier;
 }
 
 void UInteractableComponent::DrawDebugStrings(const AActor* Player) const
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractableDrawDebugStrings);
+
 	if (!Player)
 	{
 		UE_LOG(InteractionSystem, Warning, TEXT("Player passed to DrawDebugStrings() is nullptr."));
 		return;
 	}
 
-	UPlayerInteractionComponent* PlayerInteractionComponent = Player
-		->FindComponentByClass<UPlayerInteractionComponent>();
+	UPlayerInteractionComponent* PlayerInteractionComponent =
+		UInteractionSubsystem::FindPlayerInteractionComponent(Player);
 
 	if (!PlayerInteractionComponent)
 	{
@@ -455,67 +567,81 @@ void UInteractableComponent::DrawDebugStrings(const AActor* Player) const
 		return;
 	}
 
-	if (GetWorld() && SubscribedPlayers.Num() > 0)
+	if (!GetWorld() || !PlayerComponents.Num())
 	{
-		uint8 AmountOfDebugStrings = 1;
+		return;
+	}
 
-		// Priority
-		DrawDebugString(GetWorld(),
-			InteractableStructure.bOverrideDebugStringLocation ? InteractableStructure.NewDebugStringLocation
-			: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? GetOwner()->GetActorLocation() : GetComponentLocation(), FString("Priority: ") + FString::FromInt(InteractableStructure.Priority), NULL,
-			InstancedDSP.ValidTextColor, 0.01f, InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+	const FDebugStringProperties& InstancedDSP = GetDebugStringProperties();
+	const FInteractable& Settings = GetSettings();
 
-		// Whether or not the object is disabled
-		DrawDebugString(GetWorld(),
-			InteractableStructure.bOverrideDebugStringLocation ? InteractableStructure.NewDebugStringLocation
-			: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? FVector(GetOwner()->GetActorLocation().X, GetOwner()->GetActorLocation().Y, GetOwner()->GetActorLocation().Z - InstancedDSP.HeightDifferenceInDebugStrings)
-			: FVector(GetComponentLocation().X, GetComponentLocation().Y, GetComponentLocation().Z - InstancedDSP.HeightDifferenceInDebugStrings),
-			FString("Usability: ") + (InteractableStructure.bDisabled ? FString("Disabled") : FString("Enabled")), NULL,
-			!InteractableStructure.bDisabled ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor,
-			0.01f, InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+	const FVector Location = Settings.bOverrideDebugStringLocation ? Settings.NewDebugStringLocation
+		: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? GetOwner()->GetActorLocation()
+		: GetComponentLocation();
 
-		AmountOfDebugStrings++;
+	int32 Line = 0;
 
-		// Distance to player
-		if (InteractableStructure.bDoesDistanceToPlayerMatter)
-		{
-			DrawDebugString(GetWorld(),
-				InteractableStructure.bOverrideDebugStringLocation ? InteractableStructure.NewDebugStringLocation
-				: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? FVector(GetOwner()->GetActorLocation().X, GetOwner()->GetActorLocation().Y, GetOwner()->GetActorLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings))
-				: FVector(GetComponentLocation().X, GetComponentLocation().Y, GetComponentLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings)),
-				FString("Distance: ") + FString::SanitizeFloat(CheckDistanceToPlayer(Player), 2), NULL,
-				CheckDistanceToPlayer(Player) < InteractableStructure.MaximumDistanceToPlayer ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor,
-				0.01f, InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+	const auto DrawLine = [this, &InstancedDSP, &Location, &Line](const FString& Text, bool bValid)
+	{
+		DrawDebugString(GetWorld(), Location - FVector(0.f, 0.f, Line++ * InstancedDSP.HeightDifferenceInDebugStrings),
+			Text, nullptr, bValid ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor, 0.01f,
+			InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+	};
 
-			AmountOfDebugStrings++;
-		}
+	// Results of the player's selection pass, nothing is traced or measured again just to be drawn
+	const bool bEvaluated = LastEvaluation.Player == TObjectKey<AActor>(Player);
 
-		// Reachability
-		if (InteractableStructure.bHasToBeReacheable)
-		{
-			DrawDebugString(GetWorld(),
-				InteractableStructure.bOverrideDebugStringLocation ? InteractableStructure.NewDebugStringLocation
-				: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? FVector(GetOwner()->GetActorLocation().X, GetOwner()->GetActorLocation().Y, GetOwner()->GetActorLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings))
-				: FVector(GetComponentLocation().X, GetComponentLocation().Y, GetComponentLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings)),
-				CheckReachability(Player) ? FString("Reachability: Reachable") : FString("Reachability: Not Reachable"), NULL,
-				CheckReachability(Player) ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor,
-				0.01f, InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+	DrawLine(FString::Printf(TEXT("Priority: %d"), Priority), true);
+	DrawLine(bDisabled ? TEXT("Usability: Disabled") : TEXT("Usability: Enabled"), !bDisabled);
 
-			AmountOfDebugStrings++;
+	if (Settings.bDoesDistanceToPlayerMatter)
+	{
+		if (bEvaluated && LastEvaluation.Distance >= 0.f)
+		{
+			DrawLine(FString::Printf(TEXT("Distance: %.2f"), LastEvaluation.Distance),
+				LastEvaluation.Distance < Settings.MaximumDistanceToPlayer);
+		}
+		else
+		{
+			DrawLine(TEXT("Distance: Not Evaluated"), false);
 		}
+	}
 
-		// Angle
-		if (InteractableStructure.bDoesAngleMatter)
+	if (Settings.bHasToBeReacheable)
+	{
+		if (bEvaluated && LastEvaluation.bReachabilityChecked)
+		{
+			DrawLine(LastEvaluation.bReachable ? TEXT("Reachability: Reachable") : TEXT("Reachability: Not Reachable"),
+				LastEvaluation.bReachable);
+		}
+		else
 		{
-			DrawDebugString(GetWorld(),
-				InteractableStructure.bOverrideDebugStringLocation ? InteractableStructure.NewDebugStringLocation
-				: PlayerInteractionComponent->DSProperties.bUseOwningActorLocationForDebugText ? FVector(GetOwner()->GetActorLocation().X, GetOwner()->GetActorLocation().Y, GetOwner()->GetActorLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings))
-				: FVector(GetComponentLocation().X, GetComponentLocation().Y, GetComponentLocation().Z - (AmountOfDebugStrings * InstancedDSP.HeightDifferenceInDebugStrings)),
-				CheckAngleToPlayer(Player) == FAILED_Angle ? FString("Failed calculating angle.") : PlayerInteractionComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle && PlayerInteractionComponent->bIsUsingFirstPersonMode ? CheckAngleToPlayer(Player) == PlayerLooksAtInteractableValue ? FString("Player Looks At Interactable") : FString("Player Is Not Looking At Interactable") : FString("Angle: ") + FString::SanitizeFloat(CheckAngleToPlayer(Player), 2), NULL,
-				CheckAngleToPlayer(Player) == FAILED_Angle ? InstancedDSP.InvalidTextColor : PlayerInteractionComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle && PlayerInteractionComponent->bIsUsingFirstPersonMode ? CheckAngleToPlayer(Player) == PlayerLooksAtInteractableValue ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor : CheckAngleToPlayer(Player) <= InteractableStructure.PlayersAngleMarginOfErrorToInteractable ? InstancedDSP.ValidTextColor : InstancedDSP.InvalidTextColor,
-				0.01f, InstancedDSP.bDrawShadow/*, InstancedDSP.FontScale*/);
+			DrawLine(TEXT("Reachability: Not Evaluated"), false);
+		}
+	}
 
-			AmountOfDebugStrings++;
+	if (Settings.bDoesAngleMatter)
+	{
+		const float Angle = LastEvaluation.Angle;
+
+		if (!bEvaluated || !LastEvaluation.bAngleChecked)
+		{
+			DrawLine(TEXT("Angle: Not Evaluated"), false);
+		}
+		else if (Angle == FAILED_Angle)
+		{
+			DrawLine(TEXT("Failed calculating angle."), false);
+		}
+		else if (PlayerInteractionComponent->bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle
+			&& PlayerInteractionComponent->bIsUsingFirstPersonMode)
+		{
+			DrawLine(Angle == PlayerLooksAtInteractableValue ? TEXT("Player Looks At Interactable")
+				: TEXT("Player Is Not Looking At Interactable"), Angle == PlayerLooksAtInteractableValue);
+		}
+		else
+		{
+			DrawLine(FString::Printf(TEXT("Angle: %.2f"), Angle),
+				Angle <= Settings.PlayersAngleMarginOfErrorToInteractable);
 		}
 	}
 }
@@ -551,7 +677,7 @@ void UInteractableComponent::ShowInteractionWidgetOnInteractable(UInteractionWid
 		return;
 	}
 
-	Widget->OnTextChanged(InteractableStructure.InteractionText);
+	Widget->OnTextChanged(GetSettings().InteractionText);
 	InteractionWidgetOnInteractable->SetWidget(Widget);
 
 	if (!InteractionWidgetOnInteractable->IsVisible())
@@ -605,45 +731,272 @@ void UInteractableComponent::ShowInteractionMarker(UUserWidget* Widget)
 	}
 }
 
+const FInteractable& UInteractableComponent::GetSettings() const
+{
+	static const FInteractable DefaultSettings;
+
+	if (Definition)
+	{
+		return Definition->Settings;
+	}
+
+	return InlineDefinition ? InlineDefinition->Settings : DefaultSettings;
+}
+
+void UInteractableComponent::SetDebugPropertiesSource(UPlayerInteractionComponent* PlayerComponent)
+{
+	DebugPropertiesSource = PlayerComponent;
+}
+
+const FDebugStringProperties& UInteractableComponent::GetDebugStringProperties() const
+{
+	static const FDebugStringProperties DefaultProperties;
+
+	return DebugPropertiesSource.IsValid() ? DebugPropertiesSource->DSProperties : DefaultProperties;
+}
+
 void UInteractableComponent::Enable()
 {
-	InteractableStructure.bDisabled = false;
+	bDisabled = false;
 }
 
 void UInteractableComponent::Disable()
 {
-	InteractableStructure.bDisabled = true;
+	bDisabled = true;
+}
+
+void UInteractableComponent::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+
+	static const FInteractable DefaultSettings;
+
+	// Unchanged options need no inline definition, the defaults are used without one
+	if (!Definition && !InlineDefinition && !FInteractable::StaticStruct()->CompareScriptStruct(
+		&InteractableStructure_DEPRECATED, &DefaultSettings, PPF_None))
+	{
+		InlineDefinition = NewObject<UInteractableDefinition>(this, NAME_None,
+			GetMaskedFlags(RF_PropagateToSubObjects));
+		InlineDefinition->Settings = InteractableStructure_DEPRECATED;
+	}
+
+#endif //WITH_EDITORONLY_DATA
+}
+
+void UInteractableComponent::OnRegister()
+{
+	INTERACTION_LLM_SCOPE(Components);
+
+	Super::OnRegister();
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RegisterComponent(this);
+	}
+}
+
+void UInteractableComponent::OnUnregister()
+{
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->UnregisterComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void UInteractableComponent::JoinCluster(UInteractableClusterComponent* NewCluster)
+{
+	Cluster = NewCluster;
+
+	if (HasBegunPlay())
+	{
+		SphereComponent->SetGenerateOverlapEvents(false);
+	}
+}
+
+void UInteractableComponent::LeaveCluster()
+{
+	Cluster.Reset();
+
+	if (HasBegunPlay() && GetNetMode() != NM_DedicatedServer && !IsBeingDestroyed())
+	{
+		SphereComponent->SetGenerateOverlapEvents(true);
+	}
+}
+
+void UInteractableComponent::OnTransformUpdated(USceneComponent* UpdatedComponent,
+	EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->NotifyInteractableMoved(this);
+	}
+}
+
+void UInteractableComponent::SetPriority(int32 NewPriority)
+{
+	if (Priority == NewPriority)
+	{
+		return;
+	}
+
+	Priority = NewPriority;
+
+	OnPriorityChanged();
+}
+
+void UInteractableComponent::OnRep_Priority()
+{
+	OnPriorityChanged();
+}
+
+void UInteractableComponent::OnPriorityChanged()
+{
+	for (const auto& PlayerComponent : PlayerComponents)
+	{
+		if (PlayerComponent.IsValid())
+		{
+			PlayerComponent->OnInteractablePriorityChanged(this);
+		}
+	}
+}
+
+void UInteractableComponent::RandomizeValues()
+{
+	FRandomStream Stream;
+	const UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+	const bool bSeeded = Subsystem && Subsystem->GetRandomStream(this, Stream);
+
+	// Clients receive the priority of replicated interactables from the server
+	if (GetSettings().bRandomizePriority && (!GetOwner() || GetOwner()->HasAuthority()))
+	{
+		SetPriority(bSeeded ? Stream.RandRange(GetSettings().PriorityRandomizedMIN, GetSettings().PriorityRandomizedMAX)
+			: FMath::RandRange(GetSettings().PriorityRandomizedMIN, GetSettings().PriorityRandomizedMAX));
+	}
+
+	if (RandomizeRarityValue)
+	{
+		RarityValue = bSeeded ? Stream.RandRange(RarityRandomizedMIN, RarityRandomizedMAX)
+			: FMath::RandRange(RarityRandomizedMIN, RarityRandomizedMAX);
+	}
 }
 
 void UInteractableComponent::BeginPlay()
 {
+	INTERACTION_LLM_SCOPE(Components);
+
 	InteractionMarker->SetVisibility(false);
 	InteractionWidgetOnInteractable->SetVisibility(false);
 	InteractableName->SetVisibility(false);
 
-	if (InteractableStructure.bRandomizePriority)
+	// Per-instance state starts from the options, clients receive it from the server instead
+	if (!GetOwner() || GetOwner()->HasAuthority())
 	{
-		InteractableStructure.Priority = FMath::RandRange(InteractableStructure.PriorityRandomizedMIN,
-			InteractableStructure.PriorityRandomizedMAX);
+		Priority = GetSettings().Priority;
+		bDisabled |= GetSettings().bDisabled;
 	}
 
-	if (RandomizeRarityValue)
-	{
-		RarityValue = FMath::RandRange(RarityRandomizedMIN, RarityRandomizedMAX);
-	}
+	RandomizeValues();
 
 	SetComponentTickEnabled(true);
 
-	GetWorld()->GetTimerManager().SetTimer(InteractionTimerHandle, this, &UInteractableComponent::CheckOverlappingActors, 1.f, false, 0.2f);
-
 	SphereComponent->OnComponentBeginOverlap.AddDynamic(this,
 		&UInteractableComponent::OnOverlapBegin);
 	SphereComponent->OnComponentEndOverlap.AddDynamic(this,
 		&UInteractableComponent::OnOverlapEnd);
 
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	// Registration and the initial overlap check of streamed levels are done in bulk by the subsystem
+	const bool bStreamed = Subsystem && UInteractionSubsystem::IsInStreamedLevel(this);
+
+	if (bStreamed)
+	{
+		Subsystem->QueueStreamedInInteractable(this);
+	}
+
+	// Members of a cluster are discovered by the cluster
+	if (Cluster.IsValid())
+	{
+		SphereComponent->SetGenerateOverlapEvents(false);
+	}
+	else if (!bStreamed && Subsystem)
+	{
+		// Players already inside the sphere get no begin overlap, resolved in one batched pass by the subsystem
+		Subsystem->QueueInitialOverlapCheck(this, -1.f);
+	}
+
+	if (GetOwner() && GetOwner()->HasAuthority() && UInteractionSubsystem::IsServerCandidateTrackingEnabled())
+	{
+		if (Subsystem)
+		{
+			if (!bStreamed)
+			{
+				Subsystem->RegisterInteractable(this);
+			}
+
+			TransformUpdatedHandle = TransformUpdated.AddUObject(this, &UInteractableComponent::OnTransformUpdated);
+		}
+
+		// Nobody is locally controlled on a dedicated server, the spatial grid replaces the overlap sphere
+		if (GetWorld()->GetNetMode() == NM_DedicatedServer)
+		{
+			SphereComponent->SetGenerateOverlapEvents(false);
+		}
+	}
+
 	Super::BeginPlay();
 }
 
+void UInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	// Players and the spatial grid drop every interactable of the level at once when it finished streaming out
+	if (EndPlayReason == EEndPlayReason::RemovedFromWorld && Subsystem)
+	{
+		TransformUpdated.Remove(TransformUpdatedHandle);
+
+		if (Cluster.IsValid())
+		{
+			Cluster->RemoveMember(this);
+		}
+
+		Subsystem->QueueStreamedOutInteractable(this);
+
+		Super::EndPlay(EndPlayReason);
+		return;
+	}
+
+	// Copy since RemoveInteractable unsubscribes the players from this component, which edits PlayerComponents
+	const TArray<TWeakObjectPtr<UPlayerInteractionComponent>, TInlineAllocator<4>> Subscribers = PlayerComponents;
+
+	for (const auto& Subscriber : Subscribers)
+	{
+		if (Subscriber.IsValid())
+		{
+			Subscriber->RemoveInteractable(this);
+		}
+	}
+
+	if (Cluster.IsValid())
+	{
+		Cluster->RemoveMember(this);
+	}
+
+	TransformUpdated.Remove(TransformUpdatedHandle);
+
+	if (Subsystem)
+	{
+		Subsystem->UnregisterInteractable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UInteractableComponent::CheckOverlappingActors()
 {
 	TArray<AActor*> OverlappingActors;
@@ -653,8 +1006,7 @@ void UInteractableComponent::CheckOverlappingActors()
 	{
 		if (Actor != GetOwner())
 		{
-			if (UPlayerInteractionComponent* Component = Actor->
-				FindComponentByClass<UPlayerInteractionComponent>())
+			if (UPlayerInteractionComponent* Component = UInteractionSubsystem::FindPlayerInteractionComponent(Actor))
 			{
 				Component->AddActorToInteract(GetOwner());
 			}
@@ -674,9 +1026,9 @@ bool UInteractableComponent::IsAnySubscribedPlayerLocallyControlled()
 
 APawn* UInteractableComponent::GetLocallyControlledPlayer() const
 {
-	for (const auto& SubscribedPlayer : SubscribedPlayers)
+	for (const auto& PlayerComponent : PlayerComponents)
 	{
-		APawn* PlayerPawn = Cast<APawn>(SubscribedPlayer);
+		APawn* PlayerPawn = PlayerComponent.IsValid() ? Cast<APawn>(PlayerComponent->GetOwner()) : nullptr;
 
 		if (PlayerPawn && PlayerPawn->IsLocallyControlled())
 		{
@@ -708,6 +1060,8 @@ void UInteractableComponent::SetWidgetRotationSettings(bool IsCameraRotation, bo
 
 void UInteractableComponent::RotateWidgetsToPlayer(bool ToCamera)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractableRotateWidgets);
+
 	if (!GetLocallyControlledPlayer())
 	{
 		UE_LOG(InteractionSystem, Error, TEXT("ERROR: Trying to rotate widgets in RotateWidgetsToPlayer() without local player."));
@@ -734,7 +1088,7 @@ void UInteractableComponent::RotateWidgetsToPlayer(bool ToCamera)
 	}
 }
 
-void UInteractableComponent::BroadcastCanInteract(const UPlayerInteractionComponent* PlayerComponent) const
+void UInteractableComponent::BroadcastCanInteract(UPlayerInteractionComponent* PlayerComponent)
 {
 	if (!PlayerComponent)
 	{
@@ -743,15 +1097,7 @@ void UInteractableComponent::BroadcastCanInteract(const UPlayerInteractionCompon
 		return;
 	}
 
-	if (PlayerComponent->OnCanInteractDelegate.IsBound())
-	{
-		PlayerComponent->OnCanInteractDelegate.Broadcast(GetOwner());
-	}
-
-	if (OnCanInteractDelegate.IsBound())
-	{
-		OnCanInteractDelegate.Broadcast(PlayerComponent->GetOwner());
-	}
+	UInteractionSubsystem::BroadcastEvent(EInteractionEvent::CanInteract, this, PlayerComponent);
 }
 
 bool UInteractableComponent::CanAnyPlayerInteract()
@@ -759,7 +1105,7 @@ bool UInteractableComponent::CanAnyPlayerInteract()
 	for (const auto& Component : PlayerComponents)
 	{
 		if (Component.IsValid() && Component.Get() &&
-			CanInteract(Component.Get()->GetOwner()))
+			Component.Get()->CanInteractCached(this))
 		{
 			return true;
 		}
@@ -784,7 +1130,7 @@ void UInteractableComponent::ShowInteractableName(UNameWidget* Widget)
 		return;
 	}
 
-	Widget->OnNameChanged(InteractableStructure.InteractableName);
+	Widget->OnNameChanged(GetSettings().InteractableName);
 
 	if (!InteractableName)
 	{
@@ -815,7 +1161,9 @@ void UInteractableComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(UInteractableComponent, InteractableStructure);
+	DOREPLIFETIME(UInteractableComponent, Definition);
+	DOREPLIFETIME(UInteractableComponent, bDisabled);
+	DOREPLIFETIME(UInteractableComponent, Priority);
 }
 
 void UInteractableComponent::TryHideWidgets(UPlayerInteractionComponent* PlayerComponent)
@@ -829,9 +1177,9 @@ void UInteractableComponent::TryHideWidgets(UPlayerInteractionComponent* PlayerC
 	if (((PlayerComponent->bShowOnlyOneInteractableName
 		&& PlayerComponent->InteractableInteracted.IsValid()
 		&& PlayerComponent->InteractableInteracted.Get() != this)
-		|| InteractableStructure.bDisabled)
+		|| bDisabled)
 		|| (PlayerComponent->bHideInteractableNameWhenInteractableIsUnreachable
-		&&	!CheckReachability(PlayerComponent->GetOwner()))
+		&&	!PlayerComponent->IsReachableCached(this))
 		)
 	{
 		PlayerComponent->TryHideInteractableName(this);
@@ -848,18 +1196,28 @@ void UInteractableComponent::TryHideWidgets(UPlayerInteractionComponent* PlayerC
 void UInteractableComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	FActorComponentTickFunction* ThisTickFunction)
 {
+	INTERACTION_BENCHMARK_SCOPE();
+	SCOPE_CYCLE_COUNTER(STAT_InteractableTick);
+	TRACE_INTERACTION_SCOPE(Interaction_InteractableTick);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	if (SubscribedPlayers.Num())
+	INC_DWORD_STAT_BY(STAT_InteractionSubscribedPairs, PlayerComponents.Num());
+
+	if (PlayerComponents.Num())
 	{
-		if ((InstancedDSP.bDrawDebugStringsByDefault && InteractableStructure.bAlwaysDrawDebugStrings)
-			|| InteractableStructure.bAlwaysDrawDebugStrings)
+		if ((GetDebugStringProperties().bDrawDebugStringsByDefault && GetSettings().bAlwaysDrawDebugStrings)
+			|| GetSettings().bAlwaysDrawDebugStrings)
 		{
 			if (GetLocallyControlledPlayer())
 			{
 #if !UE_BUILD_SHIPPING
 
-				DrawDebugStrings(GetLocallyControlledPlayer());
+				// The debug overlay draws the same results once per frame for all candidates
+				if (!UInteractionSubsystem::IsDebugOverlayEnabled())
+				{
+					DrawDebugStrings(GetLocallyControlledPlayer());
+				}
 
 #endif //!UE_BUILD_SHIPPING
 			}
@@ -871,104 +1229,93 @@ void UInteractableComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 		}
 	}
 
-	if (PlayerComponents.Num())
+	// Iterated backwards by index since delegates broadcasted below may unsubscribe players
+	for (int32 Index = PlayerComponents.Num() - 1; Index >= 0; --Index)
 	{
-		for (const auto& Component : PlayerComponents)
+		if (!PlayerComponents.IsValidIndex(Index))
 		{
-			if (!InteractableStructure.bDisabled && CheckReachability(Component->GetOwner()))
-			{
-				if (!InteractionMarker->IsVisible())
-				{
-					Component->TryShowInteractionMarker(this);
-				}
+			continue;
+		}
 
-				if (Component->CanSelectOnlyOneInteractable &&
-					!Component->InteractableInteracted.IsValid() &&
-					CanInteract(Component->GetOwner())
-				)
-				{
-					Component->InteractableInteracted = this;
-				}
-				else if (Component->CanSelectOnlyOneInteractable 
-					&& Component->InteractableInteracted.IsValid() 
-					&& CanInteract(Component->GetOwner())
-					&& Component->InteractableInteracted.Get() != this
-				)
-				{
-					if (CanInteract(Component->GetOwner()))
-					{
-						Component->InteractableInteracted = this;
-					}
-				}
+		UPlayerInteractionComponent* Component = PlayerComponents[Index].Get();
 
-				if (!Component->InteractableInteracted.IsValid() ||
-					Component->InteractableInteracted.Get() != this)
-				{
-					TryHideWidgets(Component.Get());
-				}
+		if (!Component)
+		{
+			continue;
+		}
 
-				if (!InteractableName->IsVisible() 
-					&& !Component->bShowOnlyOneInteractableName
-					|| !Component->InteractableInteracted.IsValid())
-				{
-					if (!Component->InteractableInteracted.IsValid())
-					{
-						Component->InteractableInteracted = this;
-					}
+		// Reachability and CanInteract come from the player's selection pass of this frame
+		if (!bDisabled && Component->IsReachableCached(this))
+		{
+			if (!InteractionMarker->IsVisible())
+			{
+				Component->TryShowInteractionMarker(this);
+			}
 
-					Component->TryShowInteractableName(this);
-				}
+			const bool bCanInteract = Component->CanInteractCached(this);
 
-				if (!InteractableName->IsVisible() &&
-					Component->bShowOnlyOneInteractableName &&
-					Component->InteractableInteracted.IsValid() &&
-					Component->InteractableInteracted.Get() == this)
-				{
-					Component->TryShowInteractableName(this);
-				}
-				else if (InteractableName->IsVisible() &&
-					Component->bShowOnlyOneInteractableName &&
-					Component->InteractableInteracted.IsValid() &&
-					Component->InteractableInteracted.Get() != this)
-				{
-					Component->TryHideInteractableName(this);
-				}
+			if (!Component->InteractableInteracted.IsValid() ||
+				Component->InteractableInteracted.Get() != this)
+			{
+				TryHideWidgets(Component);
+			}
 
-				if (CanInteract(Component->GetOwner()))
-				{
-					Component->TryShowInteractionWidget(this);
-					Component->TryShowInteractionWidgetOnInteractable(this);
-					
-					if (bCanBroadcastCanInteract)
-					{
-						BroadcastCanInteract(Component.Get());
-						bCanBroadcastCanInteract = false;
-					}
-				}
-				else
-				{
-					if (!CanAnyPlayerInteract())
-					{
-						bCanBroadcastCanInteract = true;
-					}
+			// Only ApplySelection assigns InteractableInteracted, until then the scored candidate shows its name
+			if (!InteractableName->IsVisible() && (!Component->bShowOnlyOneInteractableName
+				|| (!Component->InteractableInteracted.IsValid() && Component->GetScoredCandidate() == this)))
+			{
+				Component->TryShowInteractableName(this);
+			}
 
-					Component->TryHideInteractionWidget(this);
-					Component->TryHideInteractionWidgetOnInteractable(this);
-				}
+			if (!InteractableName->IsVisible() &&
+				Component->bShowOnlyOneInteractableName &&
+				Component->InteractableInteracted.IsValid() &&
+				Component->InteractableInteracted.Get() == this)
+			{
+				Component->TryShowInteractableName(this);
 			}
-			else
+			else if (InteractableName->IsVisible() &&
+				Component->bShowOnlyOneInteractableName &&
+				Component->InteractableInteracted.IsValid() &&
+				Component->InteractableInteracted.Get() != this)
+			{
+				Component->TryHideInteractableName(this);
+			}
+
+			if (bCanInteract)
 			{
-				if (Component->bHideInteractionMarkerWhenInteractableIsUnreachable)
+				Component->TryShowInteractionWidget(this);
+				Component->TryShowInteractionWidgetOnInteractable(this);
+				
+				if (bCanBroadcastCanInteract)
 				{
-					Component->TryHideInteractionMarker(this);
+					BroadcastCanInteract(Component);
+					bCanBroadcastCanInteract = false;
 				}
-				else if (!InteractionMarker->IsVisible())
+			}
+			else
+			{
+				if (!CanAnyPlayerInteract())
 				{
-					Component->TryShowInteractionMarker(this);
+					bCanBroadcastCanInteract = true;
 				}
 
-				TryHideWidgets(Component.Get());
+				Component->TryHideInteractionWidget(this);
+				Component->TryHideInteractionWidgetOnInteractable(this);
+			}
+		}
+		else
+		{
+			if (Component->bHideInteractionMarkerWhenInteractableIsUnreachable)
+			{
+				Component->TryHideInteractionMarker(this);
 			}
+			else if (!InteractionMarker->IsVisible())
+			{
+				Component->TryShowInteractionMarker(this);
+			}
+
+			TryHideWidgets(Component);
 		}
 	}
 
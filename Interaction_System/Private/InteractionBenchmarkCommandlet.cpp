@@ -0,0 +1,328 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionBenchmarkCommandlet.h"
+#include "InteractionNetBenchmark.h"
+#include "InteractableComponent.h"
+#include "InteractableClusterComponent.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractionSubsystem.h"
+#include "InteractionStats.h"
+#include "InteractionLog.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "UObject/UObjectIterator.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace InteractionBenchmark
+{
+	static float Percentile(TArray<float> Values, float Fraction)
+	{
+		if (!Values.Num())
+		{
+			return 0.f;
+		}
+
+		Values.Sort();
+
+		return Values[FMath::Min(Values.Num() - 1, FMath::FloorToInt(Values.Num() * Fraction))];
+	}
+
+	static float Mean(const TArray<float>& Values)
+	{
+		float Sum = 0.f;
+
+		for (const float Value : Values)
+		{
+			Sum += Value;
+		}
+
+		return Values.Num() ? Sum / Values.Num() : 0.f;
+	}
+
+	// Every pawn walks its own circle through the field, identical on every run
+	static FVector GetPathLocation(int32 PawnIndex, int32 Frame, float HalfSize)
+	{
+		const float Radius = HalfSize * (0.2f + 0.7f * FMath::Frac(PawnIndex * 0.618034f));
+		const float Angle = Frame * 0.01f + PawnIndex * 2.399963f;
+
+		return FVector(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.f);
+	}
+}
+
+UInteractionBenchmarkCommandlet::UInteractionBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UInteractionBenchmarkCommandlet::Main(const FString& Params)
+{
+#if UE_BUILD_SHIPPING
+	UE_LOG(InteractionSystem, Error, TEXT("Interaction benchmark is not available in shipping builds."));
+	return 1;
+#else
+	FString Counts(TEXT("1000,10000,50000"));
+	int32 NumPawns = 1;
+	int32 NumFrames = 600;
+	float Spacing = 150.f;
+	int32 Seed = 7;
+	int32 Parallel = INDEX_NONE;
+	FString OutputPath = FPaths::ProfilingDir() / TEXT("InteractionBench") /
+		FString::Printf(TEXT("InteractionBench_%s"), *FDateTime::Now().ToString());
+
+	FParse::Value(*Params, TEXT("Counts="), Counts);
+	FParse::Value(*Params, TEXT("Pawns="), NumPawns);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	FParse::Value(*Params, TEXT("Spacing="), Spacing);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	FParse::Value(*Params, TEXT("Parallel="), Parallel);
+
+	if (Parallel != INDEX_NONE)
+	{
+		if (IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Interaction.ParallelEvaluation")))
+		{
+			CVar->Set(Parallel);
+		}
+	}
+
+	TArray<FString> CountStrings;
+	Counts.ParseIntoArray(CountStrings, TEXT(","));
+
+	TArray<FInteractionBenchmarkResult> Results;
+
+	for (const FString& CountString : CountStrings)
+	{
+		const int32 NumInteractables = FCString::Atoi(*CountString);
+
+		if (NumInteractables <= 0)
+		{
+			continue;
+		}
+
+		const FInteractionBenchmarkResult& Result = Results.Add_GetRef(
+			RunBenchmark(NumInteractables, FMath::Max(NumPawns, 1), FMath::Max(NumFrames, 1), Spacing, Seed));
+
+		UE_LOG(InteractionSystem, Display,
+			TEXT("%d interactables (%s, %d workers): plugin mean %.3f ms, p99 %.3f ms, frame mean %.3f ms, %.1f traces per frame, %lld plugin bytes"),
+			Result.Interactables, Result.bParallel ? TEXT("parallel") : TEXT("serial"), Result.Workers,
+			Result.MeanPluginMs, Result.P99PluginMs, Result.MeanFrameMs, Result.TracesPerFrame, Result.PluginObjectBytes);
+	}
+
+	WriteResults(Results, OutputPath);
+
+	return 0;
+#endif //UE_BUILD_SHIPPING
+}
+
+void UInteractionBenchmarkCommandlet::SpawnInteractables(UWorld* World, int32 NumInteractables, float Spacing,
+	int32 Seed) const
+{
+	FRandomStream RandomStream(Seed);
+
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumInteractables)));
+	const float HalfSize = Side * Spacing * 0.5f;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParameters.bDeferConstruction = true;
+
+	for (int32 Index = 0; Index < NumInteractables; ++Index)
+	{
+		const FTransform Transform(FVector((Index % Side) * Spacing - HalfSize, (Index / Side) * Spacing - HalfSize, 100.f));
+
+		AInteractionBenchmarkActor* Actor = World->SpawnActor<AInteractionBenchmarkActor>(
+			AInteractionBenchmarkActor::StaticClass(), Transform, SpawnParameters);
+
+		if (!Actor)
+		{
+			continue;
+		}
+
+		// The variant is applied before BeginPlay, actors with the same variant share one definition
+		Actor->SettingsVariant = RandomStream.RandRange(0, AInteractionBenchmarkActor::NumSettingsVariants - 1);
+		Actor->FinishSpawning(Transform);
+
+		if (Actor->Interactable)
+		{
+			Actor->Interactable->SetPriority(RandomStream.RandRange(0, 255));
+		}
+	}
+}
+
+FInteractionBenchmarkResult UInteractionBenchmarkCommandlet::RunBenchmark(int32 NumInteractables, int32 NumPawns,
+	int32 NumFrames, float Spacing, int32 Seed) const
+{
+	FInteractionBenchmarkResult Result;
+	Result.Interactables = NumInteractables;
+	Result.Pawns = NumPawns;
+	Result.Frames = NumFrames;
+	Result.Workers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+	Result.bParallel = UInteractionSubsystem::IsParallelEvaluationEnabled();
+
+	const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("InteractionBenchmark"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+
+	// No game mode, begin play is routed through the world settings directly
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	double StartTime = FPlatformTime::Seconds();
+	SpawnInteractables(World, NumInteractables, Spacing, Seed);
+	Result.SpawnMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumInteractables)));
+	const float HalfSize = Side * Spacing * 0.5f;
+
+	TArray<AInteractionBenchmarkPawn*> Pawns;
+
+	for (int32 PawnIndex = 0; PawnIndex < NumPawns; ++PawnIndex)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		AInteractionBenchmarkPawn* Pawn = World->SpawnActor<AInteractionBenchmarkPawn>(
+			InteractionBenchmark::GetPathLocation(PawnIndex, 0, HalfSize), FRotator::ZeroRotator, SpawnParameters);
+
+		// Controllers are local in a standalone world so the pawns go through the same paths as a local player
+		APlayerController* Controller = World->SpawnActor<APlayerController>(SpawnParameters);
+
+		if (Pawn && Controller)
+		{
+			Controller->Possess(Pawn);
+			Pawns.Add(Pawn);
+		}
+	}
+
+	TArray<float> PluginTimesMs;
+	TArray<float> FrameTimesMs;
+	PluginTimesMs.Reserve(NumFrames);
+	FrameTimesMs.Reserve(NumFrames);
+
+	uint64 TotalTraces = 0;
+	const float DeltaTime = 1.f / 60.f;
+
+	FInteractionBenchmarkCounters::bEnabled = true;
+	FInteractionBenchmarkCounters::Reset();
+
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 PawnIndex = 0; PawnIndex < Pawns.Num(); ++PawnIndex)
+		{
+			const FVector Location = InteractionBenchmark::GetPathLocation(PawnIndex, Frame, HalfSize);
+			const FVector Direction = (InteractionBenchmark::GetPathLocation(PawnIndex, Frame + 1, HalfSize) - Location);
+
+			Pawns[PawnIndex]->SetActorLocationAndRotation(Location, Direction.Rotation());
+			Pawns[PawnIndex]->GetController()->SetControlRotation(Direction.Rotation());
+
+			// Fixed interaction cadence, staggered between pawns
+			if ((Frame + PawnIndex * 17) % 90 == 0)
+			{
+				INTERACTION_BENCHMARK_SCOPE();
+
+				Pawns[PawnIndex]->PlayerInteraction->InteractWithInteractables();
+				++Result.Interactions;
+			}
+			else if ((Frame + PawnIndex * 17) % 90 == 60)
+			{
+				INTERACTION_BENCHMARK_SCOPE();
+
+				Pawns[PawnIndex]->PlayerInteraction->StopInteraction();
+			}
+		}
+
+		const uint64 CyclesBefore = FInteractionBenchmarkCounters::Cycles;
+		const uint32 TracesBefore = FInteractionBenchmarkCounters::Traces;
+
+		StartTime = FPlatformTime::Seconds();
+
+		World->Tick(LEVELTICK_All, DeltaTime);
+		++GFrameCounter;
+
+		FrameTimesMs.Add(static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0));
+		PluginTimesMs.Add(static_cast<float>(FPlatformTime::ToMilliseconds64(
+			FInteractionBenchmarkCounters::Cycles - CyclesBefore)));
+
+		TotalTraces += FInteractionBenchmarkCounters::Traces - TracesBefore;
+	}
+
+	FInteractionBenchmarkCounters::bEnabled = false;
+
+	Result.MeanPluginMs = InteractionBenchmark::Mean(PluginTimesMs);
+	Result.P99PluginMs = InteractionBenchmark::Percentile(PluginTimesMs, 0.99f);
+	Result.MaxPluginMs = InteractionBenchmark::Percentile(PluginTimesMs, 1.f);
+	Result.MeanFrameMs = InteractionBenchmark::Mean(FrameTimesMs);
+	Result.P99FrameMs = InteractionBenchmark::Percentile(FrameTimesMs, 0.99f);
+	Result.TracesPerFrame = static_cast<float>(TotalTraces) / NumFrames;
+	Result.CreatedWidgets = FInteractionBenchmarkCounters::CreatedWidgets;
+
+	// Exclusive size of the plugin's own objects, the process delta also contains actors and physics bodies
+	for (TObjectIterator<UActorComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && (It->IsA<UInteractableComponent>() || It->IsA<UPlayerInteractionComponent>()
+			|| It->IsA<UInteractableClusterComponent>()))
+		{
+			Result.PluginObjectBytes += It->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
+
+	Result.UsedPhysicalDeltaBytes = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical)
+		- static_cast<int64>(UsedPhysicalBefore);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	CollectGarbage(RF_NoFlags);
+
+	return Result;
+}
+
+void UInteractionBenchmarkCommandlet::WriteResults(const TArray<FInteractionBenchmarkResult>& Results,
+	const FString& OutputPath) const
+{
+	FString Csv(TEXT("Interactables,Pawns,Frames,Workers,Parallel,SpawnMs,MeanPluginMs,P99PluginMs,MaxPluginMs,MeanFrameMs,P99FrameMs,TracesPerFrame,CreatedWidgets,Interactions,PluginObjectBytes,UsedPhysicalDeltaBytes\n"));
+	FString Json(TEXT("[\n"));
+
+	for (int32 Index = 0; Index < Results.Num(); ++Index)
+	{
+		const FInteractionBenchmarkResult& Result = Results[Index];
+
+		Csv += FString::Printf(TEXT("%d,%d,%d,%d,%d,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%u,%u,%lld,%lld\n"),
+			Result.Interactables, Result.Pawns, Result.Frames, Result.Workers, Result.bParallel ? 1 : 0, Result.SpawnMs,
+			Result.MeanPluginMs, Result.P99PluginMs, Result.MaxPluginMs, Result.MeanFrameMs, Result.P99FrameMs,
+			Result.TracesPerFrame, Result.CreatedWidgets, Result.Interactions, Result.PluginObjectBytes,
+			Result.UsedPhysicalDeltaBytes);
+
+		Json += FString::Printf(TEXT("\t{\"Interactables\": %d, \"Pawns\": %d, \"Frames\": %d, \"Workers\": %d, ")
+			TEXT("\"Parallel\": %s, \"SpawnMs\": %.3f, ")
+			TEXT("\"MeanPluginMs\": %.4f, \"P99PluginMs\": %.4f, \"MaxPluginMs\": %.4f, \"MeanFrameMs\": %.4f, ")
+			TEXT("\"P99FrameMs\": %.4f, \"TracesPerFrame\": %.2f, \"CreatedWidgets\": %u, \"Interactions\": %u, ")
+			TEXT("\"PluginObjectBytes\": %lld, \"UsedPhysicalDeltaBytes\": %lld}%s\n"),
+			Result.Interactables, Result.Pawns, Result.Frames, Result.Workers,
+			Result.bParallel ? TEXT("true") : TEXT("false"), Result.SpawnMs, Result.MeanPluginMs, Result.P99PluginMs,
+			Result.MaxPluginMs, Result.MeanFrameMs, Result.P99FrameMs, Result.TracesPerFrame, Result.CreatedWidgets,
+			Result.Interactions, Result.PluginObjectBytes, Result.UsedPhysicalDeltaBytes,
+			Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+	}
+
+	Json += TEXT("]\n");
+
+	FFileHelper::SaveStringToFile(Csv, *(OutputPath + TEXT(".csv")));
+	FFileHelper::SaveStringToFile(Json, *(OutputPath + TEXT(".json")));
+
+	UE_LOG(InteractionSystem, Display, TEXT("Interaction benchmark results written to %s.csv and .json"), *OutputPath);
+}
@@ -0,0 +1,178 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionEvaluation.h"
+#include "InteractionSubsystem.h"
+#include "InteractionStats.h"
+
+#include "Components/SphereComponent.h"
+#include "Components/WidgetComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "SceneView.h"
+
+DECLARE_CYCLE_STAT(TEXT("CheckReachability"), STAT_InteractableCheckReachability, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("CheckAngleToPlayer"), STAT_InteractableCheckAngle, STATGROUP_InteractionSystem);
+
+void FInteractionEvaluationJob::Evaluate(const UWorld* World, const FInteractionEvaluationView& View)
+{
+	if (!Interactable || !World)
+	{
+		return;
+	}
+
+	if (bAlwaysCheckReachability)
+	{
+		ResolveReachability(World, View);
+	}
+
+	if (bDisabled)
+	{
+		Evaluation.Result = EInteractionEvaluationResult::Disabled;
+		return;
+	}
+
+	if (bDistanceMatters)
+	{
+		Evaluation.Distance = bSubscribed ? FVector::Dist(Location, View.PawnLocation) : -1.f;
+
+		if (Evaluation.Distance > MaximumDistance)
+		{
+			Evaluation.Result = EInteractionEvaluationResult::TooFar;
+			return;
+		}
+	}
+
+	if (bHasToBeReachable)
+	{
+		ResolveReachability(World, View);
+
+		if (!bReachable)
+		{
+			Evaluation.Result = EInteractionEvaluationResult::Unreachable;
+			return;
+		}
+	}
+
+	if (bAngleMatters)
+	{
+		// Logged by UInteractableComponent::ApplyEvaluation
+		if (!View.bHasPlayerComponent)
+		{
+			return;
+		}
+
+		// Evaluated once, looking at the interactable in first person mode is traced once per view
+		const float Angle = MeasureAngle(View);
+
+		Evaluation.bAngleChecked = true;
+		Evaluation.Angle = Angle;
+
+		if (Angle == FAILED_Angle ? false : View.bHasToLookAt && View.bFirstPerson ?
+			Angle != PlayerLooksAtInteractableValue :
+			Angle > AngleMargin)
+		{
+			Evaluation.Result = EInteractionEvaluationResult::WrongAngle;
+			return;
+		}
+	}
+
+	Evaluation.Result = EInteractionEvaluationResult::Usable;
+
+	const FVector ToCandidate = Location - View.SelectionLocation;
+
+	SelectionDistance = ToCandidate.Size();
+	SelectionViewDot = FVector::DotProduct(View.SelectionDirection, ToCandidate.GetSafeNormal());
+}
+
+void FInteractionEvaluationJob::ResolveReachability(const UWorld* World, const FInteractionEvaluationView& View)
+{
+	if (!bReachabilityResolved)
+	{
+		bReachable = TraceReachability(World, View);
+		bReachabilityResolved = true;
+		bReachabilityTraced = true;
+	}
+
+	Evaluation.bReachabilityChecked = true;
+	Evaluation.bReachable = bReachable;
+}
+
+bool FInteractionEvaluationJob::TraceReachability(const UWorld* World, const FInteractionEvaluationView& View) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractableCheckReachability);
+
+	FCollisionQueryParams CollisionParams;
+	FHitResult OutHit;
+
+	CollisionParams.AddIgnoredActor(InteractableOwner);
+
+	do
+	{
+		INTERACTION_INC_TRACES();
+
+		if (World->LineTraceSingleByChannel(OutHit, Location, View.PawnLocation, ECC_Visibility, CollisionParams))
+		{
+			if (OutHit.bBlockingHit)
+			{
+				if (OutHit.GetActor() && UInteractionSubsystem::FindPlayerInteractionComponent(OutHit.GetActor()))
+				{
+					return true;
+				}
+				else if (OutHit.Component.IsValid() && (OutHit.Component->IsA<USphereComponent>()
+					|| OutHit.Component->IsA<UWidgetComponent>()))
+				{
+					CollisionParams.AddIgnoredComponent(OutHit.Component.Get());
+				}
+				else
+				{
+					return false;
+				}
+			}
+		}
+	} while (OutHit.Actor.IsValid() && (UInteractionSubsystem::FindInteractableComponent(OutHit.Actor.Get())));
+
+	return false;
+}
+
+float FInteractionEvaluationJob::MeasureScreenAngle(const FVector& Location, const FInteractionEvaluationView& View)
+{
+	FVector2D ComponentScreenLocation = FVector2D::ZeroVector;
+
+	if (View.bHasViewport)
+	{
+		FSceneView::ProjectWorldToScreen(Location, View.ViewRect, View.ViewProjectionMatrix,
+			ComponentScreenLocation);
+	}
+
+	ComponentScreenLocation.Normalize();
+
+	float Dot = FVector2D::DotProduct(ComponentScreenLocation, View.ScreenCenter);
+
+	return FMath::Acos(Dot) * Multiplier; //Rad to Degrees
+}
+
+float FInteractionEvaluationJob::MeasureAngle(const FInteractionEvaluationView& View) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractableCheckAngle);
+
+	if (View.AngleFailure)
+	{
+		return FAILED_Angle;
+	}
+
+	if (View.bFirstPerson)
+	{
+		if (View.bHasToLookAt)
+		{
+			return View.LookedAtActor && View.LookedAtActor == InteractableOwner ? PlayerLooksAtInteractableValue : 0.f;
+		}
+
+		return MeasureScreenAngle(Location, View);
+	}
+
+	const FVector PlayerToInteractableLocation = (Location - View.PawnLocation).GetSafeNormal();
+
+	float Dot = FVector::DotProduct(View.ArrowForward, PlayerToInteractableLocation);
+
+	return FMath::Acos(Dot) * Multiplier; //Rad to Degrees
+}
@@ -0,0 +1,249 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionEvents.h"
+#include "InteractableComponent.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractionStats.h"
+#include "InteractionMemory.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queued Events"), STAT_InteractionQueuedEvents, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Coalesced Events"), STAT_InteractionCoalescedEvents, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Broadcasted Events"), STAT_InteractionBroadcastedEvents, STATGROUP_InteractionSystem);
+
+namespace InteractionEvents
+{
+	// Flush passes over events queued by listeners before the rest is left for the next frame
+	constexpr int32 MaxFlushPasses = 4;
+
+	enum EChannel : uint8
+	{
+		Subscription,
+		PlayerSubscription,
+		PlayerCandidates,
+		Selected,
+		CanInteract,
+		PlayerSelection
+	};
+}
+
+FInteractionEventQueue::FKey FInteractionEventQueue::MakeKey(EInteractionEvent Type,
+	const UInteractableComponent* Interactable, const UPlayerInteractionComponent* Player)
+{
+	FKey Key;
+	Key.Interactable = Interactable;
+	Key.Player = Player;
+
+	switch (Type)
+	{
+	case EInteractionEvent::Subscribed:
+	case EInteractionEvent::Unsubscribed:
+		Key.Channel = InteractionEvents::Subscription;
+		break;
+	case EInteractionEvent::InteractableSubscribed:
+	case EInteractionEvent::InteractableUnsubscribed:
+		Key.Channel = InteractionEvents::PlayerSubscription;
+		break;
+	case EInteractionEvent::FirstInteractableSubscribed:
+	case EInteractionEvent::NoInteractablesLeft:
+		Key.Interactable = nullptr;
+		Key.Channel = InteractionEvents::PlayerCandidates;
+		break;
+	case EInteractionEvent::Selected:
+		Key.Channel = InteractionEvents::Selected;
+		break;
+	case EInteractionEvent::CanInteract:
+		Key.Channel = InteractionEvents::CanInteract;
+		break;
+	case EInteractionEvent::InteractableSelected:
+		Key.Interactable = nullptr;
+		Key.Channel = InteractionEvents::PlayerSelection;
+		break;
+	}
+
+	return Key;
+}
+
+void FInteractionEventQueue::Add(EInteractionEvent Type, UInteractableComponent* Interactable,
+	UPlayerInteractionComponent* Player)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+	INC_DWORD_STAT(STAT_InteractionQueuedEvents);
+
+	const FKey Key = MakeKey(Type, Interactable, Player);
+
+	// Events of a pair that isn't subscribed anymore would reach listeners after its unsubscription
+	if (Type == EInteractionEvent::Unsubscribed || Type == EInteractionEvent::InteractableUnsubscribed)
+	{
+		CancelPairEvents(Interactable, Player);
+	}
+
+	if (const int32* LatestIndex = LatestEvents.Find(Key))
+	{
+		FInteractionEvent& Latest = Events[*LatestIndex];
+
+		if (Latest.Type != Type)
+		{
+			// Opposite of the pending event, the pair ends the frame as it started it
+			Latest.bCancelled = true;
+			LatestEvents.Remove(Key);
+			INC_DWORD_STAT_BY(STAT_InteractionCoalescedEvents, 2);
+			return;
+		}
+
+		if (Type != EInteractionEvent::InteractableSelected)
+		{
+			INC_DWORD_STAT(STAT_InteractionCoalescedEvents);
+			return;
+		}
+
+		// Only the last selection of the frame is broadcasted
+		Latest.bCancelled = true;
+		INC_DWORD_STAT(STAT_InteractionCoalescedEvents);
+	}
+
+	LatestEvents.Add(Key, Events.Num());
+
+	FInteractionEvent& Event = Events.AddDefaulted_GetRef();
+	Event.Interactable = Interactable;
+	Event.Player = Player;
+	Event.Type = Type;
+}
+
+void FInteractionEventQueue::CancelPairEvents(const UInteractableComponent* Interactable,
+	const UPlayerInteractionComponent* Player)
+{
+	static const EInteractionEvent PairEvents[] = { EInteractionEvent::Selected, EInteractionEvent::CanInteract,
+		EInteractionEvent::InteractableSelected };
+
+	for (const EInteractionEvent PairEvent : PairEvents)
+	{
+		const FKey Key = MakeKey(PairEvent, Interactable, Player);
+		const int32* LatestIndex = LatestEvents.Find(Key);
+
+		if (!LatestIndex)
+		{
+			continue;
+		}
+
+		FInteractionEvent& Latest = Events[*LatestIndex];
+
+		// The player's selection is keyed by the player alone, it may have selected another interactable
+		if (Latest.Interactable.Get(true) != Interactable)
+		{
+			continue;
+		}
+
+		Latest.bCancelled = true;
+		LatestEvents.Remove(Key);
+		INC_DWORD_STAT(STAT_InteractionCoalescedEvents);
+	}
+}
+
+void FInteractionEventQueue::Flush()
+{
+	for (int32 Pass = 0; Pass < InteractionEvents::MaxFlushPasses && Events.Num(); ++Pass)
+	{
+		Swap(Events, FlushingEvents);
+		LatestEvents.Reset();
+
+		for (const FInteractionEvent& Event : FlushingEvents)
+		{
+			if (!Event.bCancelled)
+			{
+				INC_DWORD_STAT(STAT_InteractionBroadcastedEvents);
+				Dispatch(Event);
+			}
+		}
+
+		FlushingEvents.Reset();
+	}
+}
+
+void FInteractionEventQueue::Reset()
+{
+	Events.Empty();
+	FlushingEvents.Empty();
+	LatestEvents.Empty();
+}
+
+void FInteractionEventQueue::Dispatch(const FInteractionEvent& Event)
+{
+	// Components destroyed this frame still get their unsubscriptions
+	UInteractableComponent* Interactable = Event.Interactable.Get(true);
+	UPlayerInteractionComponent* Player = Event.Player.Get(true);
+
+	AActor* InteractableOwner = Interactable ? Interactable->GetOwner() : nullptr;
+	AActor* PlayerOwner = Player ? Player->GetOwner() : nullptr;
+
+	switch (Event.Type)
+	{
+	case EInteractionEvent::Subscribed:
+		if (Interactable)
+		{
+			Interactable->OnSubscribed.Broadcast(Interactable, Player);
+			Interactable->OnSubscribedDelegate.Broadcast(PlayerOwner);
+		}
+		break;
+	case EInteractionEvent::Unsubscribed:
+		if (Interactable)
+		{
+			Interactable->OnUnsubscribed.Broadcast(Interactable, Player);
+			Interactable->OnUnsubscribedDelegate.Broadcast(PlayerOwner);
+		}
+		break;
+	case EInteractionEvent::Selected:
+		if (Interactable)
+		{
+			Interactable->OnSelected.Broadcast(Interactable, Player);
+			Interactable->OnSelectedDelegate.Broadcast(PlayerOwner);
+		}
+		break;
+	case EInteractionEvent::CanInteract:
+		if (Player)
+		{
+			Player->OnCanInteract.Broadcast(Interactable, Player);
+			Player->OnCanInteractDelegate.Broadcast(InteractableOwner);
+		}
+		if (Interactable)
+		{
+			Interactable->OnCanInteract.Broadcast(Interactable, Player);
+			Interactable->OnCanInteractDelegate.Broadcast(PlayerOwner);
+		}
+		break;
+	case EInteractionEvent::InteractableSubscribed:
+		if (Player)
+		{
+			Player->OnInteractableSubscribed.Broadcast(Interactable, Player);
+			Player->OnInteractableSubscribedDelegate.Broadcast(InteractableOwner);
+		}
+		break;
+	case EInteractionEvent::InteractableUnsubscribed:
+		if (Player)
+		{
+			Player->OnInteractableUnsubscribed.Broadcast(Interactable, Player);
+			Player->OnInteractableUnsubscribedDelegate.Broadcast(InteractableOwner);
+		}
+		break;
+	case EInteractionEvent::FirstInteractableSubscribed:
+		if (Player)
+		{
+			Player->OnFirstInteractableSubscribed.Broadcast(Interactable, Player);
+			Player->OnFirstInteractableSubscribedDelegate.Broadcast(InteractableOwner);
+		}
+		break;
+	case EInteractionEvent::NoInteractablesLeft:
+		if (Player)
+		{
+			Player->OnNoInteractablesLeft.Broadcast(Player);
+			Player->OnNoInteractablesLeftDelegate.Broadcast();
+		}
+		break;
+	case EInteractionEvent::InteractableSelected:
+		if (Player)
+		{
+			Player->OnInteractableSelected.Broadcast(Interactable, Player);
+			Player->OnInteractableSelectedDelegate.Broadcast(InteractableOwner);
+		}
+		break;
+	}
+}
@@ -0,0 +1,204 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionSpatialGrid.h"
+#include "InteractionLog.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if !UE_BUILD_SHIPPING
+
+/*Compares how the server spatial grid copes with moving interactables:
+Tiered   - static entries in one grid that is never touched, moving entries in a separate dynamic grid
+Single   - every entry in one grid, only the moving ones are updated
+Polling  - every entry in one grid and every entry updated each frame, as if nothing told the grid what moved
+Usage: Interaction.BenchmarkMovingInteractables [Static=10000] [Moving=500] [Frames=300] [Players=32] [Seed=7]*/
+namespace InteractionGridBenchmark
+{
+	struct FResult
+	{
+		double UpdateMs = 0.0;
+
+		double QueryMs = 0.0;
+
+		int64 Hits = 0;
+	};
+
+	static const float WorldExtent = 50000.f;
+
+	static const float StaticRadius = 200.f;
+
+	static const float MovingRadius = 300.f;
+
+	static const float PlayerRadius = 40.f;
+
+	struct FScenario
+	{
+		TArray<FVector> StaticLocations;
+
+		TArray<FVector> MovingLocations;
+
+		TArray<FVector> MovingVelocities;
+
+		TArray<FVector> PlayerLocations;
+	};
+
+	static FVector RandomLocation(FRandomStream& Stream)
+	{
+		return FVector(Stream.FRandRange(-WorldExtent, WorldExtent), Stream.FRandRange(-WorldExtent, WorldExtent), 0.f);
+	}
+
+	static FScenario MakeScenario(int32 NumStatic, int32 NumMoving, int32 NumPlayers, int32 Seed)
+	{
+		FRandomStream Stream(Seed);
+		FScenario Scenario;
+
+		for (int32 Index = 0; Index < NumStatic; ++Index)
+		{
+			Scenario.StaticLocations.Add(RandomLocation(Stream));
+		}
+
+		for (int32 Index = 0; Index < NumMoving; ++Index)
+		{
+			Scenario.MovingLocations.Add(RandomLocation(Stream));
+			Scenario.MovingVelocities.Add(Stream.GetUnitVector().GetSafeNormal2D() * Stream.FRandRange(100.f, 1500.f));
+		}
+
+		for (int32 Index = 0; Index < NumPlayers; ++Index)
+		{
+			Scenario.PlayerLocations.Add(RandomLocation(Stream));
+		}
+
+		return Scenario;
+	}
+
+	static void Step(TArray<FVector>& Locations, const TArray<FVector>& Velocities, float DeltaTime)
+	{
+		for (int32 Index = 0; Index < Locations.Num(); ++Index)
+		{
+			Locations[Index] += Velocities[Index] * DeltaTime;
+			Locations[Index].X = FMath::Fmod(Locations[Index].X + 3.f * WorldExtent, 2.f * WorldExtent) - WorldExtent;
+			Locations[Index].Y = FMath::Fmod(Locations[Index].Y + 3.f * WorldExtent, 2.f * WorldExtent) - WorldExtent;
+		}
+	}
+
+	static FResult Run(const FScenario& InScenario, int32 Frames, float CellSize, bool bTiered, bool bPollAll)
+	{
+		FScenario Scenario = InScenario;
+
+		TInteractionSpatialGrid<int32> StaticGrid(CellSize);
+		TInteractionSpatialGrid<int32> DynamicGrid(CellSize);
+		TInteractionSpatialGrid<int32>& MovingGrid = bTiered ? DynamicGrid : StaticGrid;
+
+		TArray<int32> StaticIndices;
+		TArray<int32> MovingIndices;
+
+		for (int32 Index = 0; Index < Scenario.StaticLocations.Num(); ++Index)
+		{
+			StaticIndices.Add(StaticGrid.Add(Scenario.StaticLocations[Index], StaticRadius, Index));
+		}
+
+		for (int32 Index = 0; Index < Scenario.MovingLocations.Num(); ++Index)
+		{
+			MovingIndices.Add(MovingGrid.Add(Scenario.MovingLocations[Index], MovingRadius, Index));
+		}
+
+		FResult Result;
+		const float DeltaTime = 1.f / 30.f;
+
+		for (int32 Frame = 0; Frame < Frames; ++Frame)
+		{
+			Step(Scenario.MovingLocations, Scenario.MovingVelocities, DeltaTime);
+
+			double StartTime = FPlatformTime::Seconds();
+
+			for (int32 Index = 0; Index < MovingIndices.Num(); ++Index)
+			{
+				MovingGrid.Update(MovingIndices[Index], Scenario.MovingLocations[Index]);
+			}
+
+			if (bPollAll)
+			{
+				for (int32 Index = 0; Index < StaticIndices.Num(); ++Index)
+				{
+					StaticGrid.Update(StaticIndices[Index], Scenario.StaticLocations[Index]);
+				}
+			}
+
+			Result.UpdateMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			StartTime = FPlatformTime::Seconds();
+
+			for (const FVector& PlayerLocation : Scenario.PlayerLocations)
+			{
+				const auto CountHit = [&Result](int32 ElementIndex, const int32& Payload)
+				{
+					++Result.Hits;
+				};
+
+				StaticGrid.Query(PlayerLocation, PlayerRadius, CountHit);
+
+				if (bTiered)
+				{
+					DynamicGrid.Query(PlayerLocation, PlayerRadius, CountHit);
+				}
+			}
+
+			Result.QueryMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		}
+
+		Result.UpdateMs /= FMath::Max(Frames, 1);
+		Result.QueryMs /= FMath::Max(Frames, 1);
+
+		return Result;
+	}
+
+	static void Execute(const TArray<FString>& Args)
+	{
+		const int32 NumStatic = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 10000;
+		const int32 NumMoving = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 500;
+		const int32 Frames = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 300;
+		const int32 NumPlayers = Args.IsValidIndex(3) ? FCString::Atoi(*Args[3]) : 32;
+		const int32 Seed = Args.IsValidIndex(4) ? FCString::Atoi(*Args[4]) : 7;
+
+		IConsoleVariable* CellSizeVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("Interaction.SpatialGridCellSize"));
+		const float CellSize = CellSizeVariable ? CellSizeVariable->GetFloat() : 1000.f;
+
+		const FScenario Scenario = MakeScenario(NumStatic, NumMoving, NumPlayers, Seed);
+
+		const TCHAR* Names[] = { TEXT("Tiered"), TEXT("Single"), TEXT("Polling") };
+		const FResult Results[] =
+		{
+			Run(Scenario, Frames, CellSize, true, false),
+			Run(Scenario, Frames, CellSize, false, false),
+			Run(Scenario, Frames, CellSize, false, true)
+		};
+
+		FString Csv = TEXT("Layout,Static,Moving,Players,Frames,UpdateMs,QueryMs,Hits\n");
+
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(Results); ++Index)
+		{
+			UE_LOG(InteractionSystem, Display, TEXT("%s: update %.4f ms, query %.4f ms per frame (%lld hits)"),
+				Names[Index], Results[Index].UpdateMs, Results[Index].QueryMs, Results[Index].Hits);
+
+			Csv += FString::Printf(TEXT("%s,%d,%d,%d,%d,%.4f,%.4f,%lld\n"), Names[Index], NumStatic, NumMoving,
+				NumPlayers, Frames, Results[Index].UpdateMs, Results[Index].QueryMs, Results[Index].Hits);
+		}
+
+		const FString CsvPath = FPaths::ProfilingDir() / TEXT("InteractionGridBench") /
+			FString::Printf(TEXT("MovingInteractables_%s.csv"), *FDateTime::Now().ToString());
+
+		FFileHelper::SaveStringToFile(Csv, *CsvPath);
+
+		UE_LOG(InteractionSystem, Display, TEXT("Moving interactables benchmark written to %s"), *CsvPath);
+	}
+}
+
+static FAutoConsoleCommand CmdBenchmarkMovingInteractables(
+	TEXT("Interaction.BenchmarkMovingInteractables"),
+	TEXT("Benchmarks the spatial grid with moving and static interactables. Args: [Static=10000] [Moving=500] [Frames=300] [Players=32] [Seed=7]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&InteractionGridBenchmark::Execute));
+
+#endif //!UE_BUILD_SHIPPING
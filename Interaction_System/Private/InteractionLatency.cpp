@@ -0,0 +1,68 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionLatency.h"
+
+int32 FInteractionLatencyHistogram::GetBucket(float Milliseconds)
+{
+	const float FineRangeMs = NumFineBuckets * FineBucketMs;
+
+	if (Milliseconds < FineRangeMs)
+	{
+		return FMath::Max(FMath::FloorToInt(Milliseconds / FineBucketMs), 0);
+	}
+
+	return FMath::Min(NumFineBuckets + FMath::FloorToInt((Milliseconds - FineRangeMs) / CoarseBucketMs),
+		NumBuckets - 1);
+}
+
+float FInteractionLatencyHistogram::GetBucketUpperBound(int32 Bucket)
+{
+	if (Bucket < NumFineBuckets)
+	{
+		return (Bucket + 1) * FineBucketMs;
+	}
+
+	return NumFineBuckets * FineBucketMs + (Bucket - NumFineBuckets + 1) * CoarseBucketMs;
+}
+
+void FInteractionLatencyHistogram::Add(float Milliseconds)
+{
+	Milliseconds = FMath::Max(Milliseconds, 0.f);
+
+	++Buckets[GetBucket(Milliseconds)];
+	++Count;
+	SumMs += Milliseconds;
+	MaxMs = FMath::Max(MaxMs, Milliseconds);
+}
+
+void FInteractionLatencyHistogram::Reset()
+{
+	FMemory::Memzero(Buckets);
+	Count = 0;
+	SumMs = 0.0;
+	MaxMs = 0.f;
+}
+
+float FInteractionLatencyHistogram::GetPercentile(float Fraction) const
+{
+	if (!Count)
+	{
+		return 0.f;
+	}
+
+	const uint32 Rank = FMath::Max(1u, static_cast<uint32>(FMath::CeilToInt(FMath::Clamp(Fraction, 0.f, 1.f) * Count)));
+	uint32 Seen = 0;
+
+	for (int32 Bucket = 0; Bucket < NumBuckets - 1; ++Bucket)
+	{
+		Seen += Buckets[Bucket];
+
+		if (Seen >= Rank)
+		{
+			// Never above the largest sample actually measured
+			return FMath::Min(GetBucketUpperBound(Bucket), MaxMs);
+		}
+	}
+
+	return MaxMs;
+}
@@ -0,0 +1,150 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionMemory.h"
+#include "InteractionSubsystem.h"
+
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemStats.h"
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction"), STAT_InteractionLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction"), STAT_InteractionSummaryLLM, STATGROUP_LLM);
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction Components"), STAT_InteractionComponentsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction Widgets"), STAT_InteractionWidgetsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction Subscriptions"), STAT_InteractionSubscriptionsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Interaction Caches"), STAT_InteractionCachesLLM, STATGROUP_LLMFULL);
+
+LLM_DEFINE_TAG(Interaction, TEXT("Interaction"), NAME_None, GET_STATFNAME(STAT_InteractionLLM),
+	GET_STATFNAME(STAT_InteractionSummaryLLM));
+LLM_DEFINE_TAG(Interaction_Components, TEXT("Components"), TEXT("Interaction"),
+	GET_STATFNAME(STAT_InteractionComponentsLLM), GET_STATFNAME(STAT_InteractionSummaryLLM));
+LLM_DEFINE_TAG(Interaction_Widgets, TEXT("Widgets"), TEXT("Interaction"),
+	GET_STATFNAME(STAT_InteractionWidgetsLLM), GET_STATFNAME(STAT_InteractionSummaryLLM));
+LLM_DEFINE_TAG(Interaction_Subscriptions, TEXT("Subscriptions"), TEXT("Interaction"),
+	GET_STATFNAME(STAT_InteractionSubscriptionsLLM), GET_STATFNAME(STAT_InteractionSummaryLLM));
+LLM_DEFINE_TAG(Interaction_Caches, TEXT("Caches"), TEXT("Interaction"),
+	GET_STATFNAME(STAT_InteractionCachesLLM), GET_STATFNAME(STAT_InteractionSummaryLLM));
+
+SIZE_T FInteractionMemoryReport::GetObjectBytes(const UObject* Object)
+{
+	if (!Object)
+	{
+		return 0;
+	}
+
+	return Object->GetClass()->GetStructureSize() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+}
+
+void FInteractionMemoryReport::AddObject(FInteractionMemoryCategory& Category, const UObject* Object)
+{
+	bool bAlreadyCounted = false;
+
+	if (Object)
+	{
+		CountedObjects.Add(Object, &bAlreadyCounted);
+	}
+
+	if (Object && !bAlreadyCounted)
+	{
+		Category.Add(1, GetObjectBytes(Object));
+	}
+}
+
+void FInteractionMemoryReport::AddWidget(const UUserWidget* Widget)
+{
+	bool bAlreadyCounted = false;
+
+	if (Widget)
+	{
+		CountedObjects.Add(Widget, &bAlreadyCounted);
+	}
+
+	if (!Widget || bAlreadyCounted)
+	{
+		return;
+	}
+
+	SIZE_T Bytes = GetObjectBytes(Widget);
+
+	if (Widget->WidgetTree)
+	{
+		Bytes += GetObjectBytes(Widget->WidgetTree);
+
+		Widget->WidgetTree->ForEachWidget([&Bytes](UWidget* Child)
+		{
+			Bytes += GetObjectBytes(Child);
+		});
+	}
+
+	Widgets.FindOrAdd(Widget->GetClass()->GetFName()).Add(1, Bytes);
+}
+
+SIZE_T FInteractionMemoryReport::GetTotalBytes() const
+{
+	SIZE_T Bytes = Components.Bytes + WidgetComponents.Bytes + SphereComponents.Bytes + Subscriptions.Bytes
+		+ Caches.Bytes + ReplicatedState.Bytes;
+
+	for (const TPair<FName, FInteractionMemoryCategory>& Widget : Widgets)
+	{
+		Bytes += Widget.Value.Bytes;
+	}
+
+	return Bytes;
+}
+
+void FInteractionMemoryReport::Log(FOutputDevice& Ar, const TCHAR* Title) const
+{
+	const auto LogCategory = [&Ar](const TCHAR* Name, const FInteractionMemoryCategory& Category)
+	{
+		Ar.Logf(TEXT("  %-40s %8d %12.1f KB"), Name, Category.Count, Category.Bytes / 1024.f);
+	};
+
+	Ar.Logf(TEXT("Interaction memory of %s: %.1f KB"), Title, GetTotalBytes() / 1024.f);
+	Ar.Logf(TEXT("  %-40s %8s %15s"), TEXT("Category"), TEXT("Count"), TEXT("Size"));
+
+	LogCategory(TEXT("Interaction components"), Components);
+	LogCategory(TEXT("Widget components"), WidgetComponents);
+	LogCategory(TEXT("Sphere components"), SphereComponents);
+	LogCategory(TEXT("Subscriptions"), Subscriptions);
+	LogCategory(TEXT("Caches"), Caches);
+	LogCategory(TEXT("Replicated state (estimated)"), ReplicatedState);
+
+	for (const TPair<FName, FInteractionMemoryCategory>& Widget : Widgets)
+	{
+		LogCategory(*FString::Printf(TEXT("Widgets: %s"), *Widget.Key.ToString()), Widget.Value);
+	}
+}
+
+static void DumpInteractionMemory(const TArray<FString>& Args, UWorld* InWorld, FOutputDevice& Ar)
+{
+	if (!GEngine)
+	{
+		return;
+	}
+
+	// Without a world, e.g. from a dedicated server console, every game world is reported
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+
+		if (!World || !World->IsGameWorld() || (InWorld && InWorld->IsGameWorld() && World != InWorld))
+		{
+			continue;
+		}
+
+		if (const UInteractionSubsystem* Subsystem = World->GetSubsystem<UInteractionSubsystem>())
+		{
+			FInteractionMemoryReport Report;
+			Subsystem->GatherMemoryReport(Report);
+			Report.Log(Ar, *World->GetName());
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdDumpInteractionMemory(
+	TEXT("Interaction.DumpMemory"),
+	TEXT("Logs counts and bytes of the interaction system per category: components, widgets by class, subscriptions and caches."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&DumpInteractionMemory));
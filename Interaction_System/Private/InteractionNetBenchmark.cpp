@@ -0,0 +1,414 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionNetBenchmark.h"
+#include "InteractableComponent.h"
+#include "InteractableDefinition.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractionStats.h"
+#include "InteractionLog.h"
+
+#include "Components/SphereComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Net/UnrealNetwork.h"
+#include "UObject/Package.h"
+
+AInteractionBenchmarkActor::AInteractionBenchmarkActor()
+{
+#if !UE_BUILD_SHIPPING
+	bReplicates = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+	Interactable = CreateDefaultSubobject<UInteractableComponent>(TEXT("Interactable"));
+	Interactable->SetupAttachment(RootComponent);
+
+	if (Interactable->SphereComponent)
+	{
+		Interactable->SphereComponent->SetupAttachment(RootComponent);
+		Interactable->SphereComponent->SetSphereRadius(200.f);
+		Interactable->SphereComponent->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
+	}
+#endif //!UE_BUILD_SHIPPING
+}
+
+UInteractableDefinition* AInteractionBenchmarkActor::GetBenchmarkDefinition(int32 Variant)
+{
+#if UE_BUILD_SHIPPING
+	return nullptr;
+#else
+	static TArray<TWeakObjectPtr<UInteractableDefinition>> Definitions;
+
+	Variant = FMath::Clamp(Variant, 0, NumSettingsVariants - 1);
+	Definitions.SetNum(NumSettingsVariants);
+
+	if (UInteractableDefinition* Existing = Definitions[Variant].Get())
+	{
+		return Existing;
+	}
+
+	// The mix covers the evaluation, hold and widget paths
+	FRandomStream RandomStream(Variant);
+
+	UInteractableDefinition* Definition = NewObject<UInteractableDefinition>(GetTransientPackage());
+	FInteractable& Settings = Definition->Settings;
+	Settings.bAlwaysDrawDebugStrings = false;
+	Settings.bHoldButtonToInteract = RandomStream.FRand() < 0.5f;
+	Settings.CanHoldMultipleTimes = RandomStream.FRand() < 0.1f;
+	Settings.bDisableAfterUsage = RandomStream.FRand() < 0.2f;
+	Settings.bHasToBeReacheable = RandomStream.FRand() < 0.7f;
+	Settings.bDoesAngleMatter = RandomStream.FRand() < 0.7f;
+	Settings.TimeInSecondsForButtonHold = RandomStream.FRandRange(0.25f, 1.f);
+
+	Definitions[Variant] = Definition;
+
+	return Definition;
+#endif //UE_BUILD_SHIPPING
+}
+
+void AInteractionBenchmarkActor::BeginPlay()
+{
+	// Clients have received the variant before BeginPlay, the definition itself is transient and never replicated
+	if (Interactable)
+	{
+		Interactable->Definition = GetBenchmarkDefinition(SettingsVariant);
+	}
+
+	Super::BeginPlay();
+}
+
+void AInteractionBenchmarkActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AInteractionBenchmarkActor, SettingsVariant);
+}
+
+AInteractionBenchmarkPawn::AInteractionBenchmarkPawn()
+{
+#if !UE_BUILD_SHIPPING
+	PlayerInteraction = CreateDefaultSubobject<UPlayerInteractionComponent>(TEXT("PlayerInteraction"));
+#endif //!UE_BUILD_SHIPPING
+}
+
+void AInteractionBenchmarkPawn::BeginPlay()
+{
+	Super::BeginPlay();
+
+#if !UE_BUILD_SHIPPING
+	// Generated benchmark maps have no floor
+	GetCharacterMovement()->GravityScale = 0.f;
+	GetCharacterMovement()->SetMovementMode(MOVE_Flying);
+#endif //!UE_BUILD_SHIPPING
+}
+
+AInteractionBenchmarkGameMode::AInteractionBenchmarkGameMode()
+{
+#if !UE_BUILD_SHIPPING
+	DefaultPawnClass = AInteractionBenchmarkPawn::StaticClass();
+#endif //!UE_BUILD_SHIPPING
+}
+
+bool UInteractionNetBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_BUILD_SHIPPING
+	return false;
+#else
+	return FParse::Param(FCommandLine::Get(), TEXT("InteractionNetBench"));
+#endif //UE_BUILD_SHIPPING
+}
+
+void UInteractionNetBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+
+	int32 Seed = 7;
+
+	FParse::Value(CommandLine, TEXT("InteractionBenchCount="), InteractableCount);
+	FParse::Value(CommandLine, TEXT("InteractionBenchSpacing="), Spacing);
+	FParse::Value(CommandLine, TEXT("InteractionBenchSeed="), Seed);
+	FParse::Value(CommandLine, TEXT("InteractionBenchDuration="), Duration);
+	FParse::Value(CommandLine, TEXT("InteractionBotIndex="), BotIndex);
+
+	bIsBot = FParse::Param(CommandLine, TEXT("InteractionBot"));
+	bExitWhenFinished = FParse::Param(CommandLine, TEXT("InteractionBenchExit"));
+
+	RandomStream.Initialize(Seed + BotIndex);
+	FrameTimesMs.Reserve(FMath::CeilToInt(Duration * 120.f));
+
+	bInitialized = true;
+}
+
+void UInteractionNetBenchmarkSubsystem::Deinitialize()
+{
+	if (bStarted && !bFinished && !bIsBot)
+	{
+		WriteReport(true);
+	}
+
+	bInitialized = false;
+
+	Super::Deinitialize();
+}
+
+void UInteractionNetBenchmarkSubsystem::StartServer()
+{
+	UWorld* World = GetWorld();
+
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(InteractableCount)));
+	const float HalfSize = Side * Spacing * 0.5f;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 Index = 0; Index < InteractableCount; ++Index)
+	{
+		const FVector Location((Index % Side) * Spacing - HalfSize, (Index / Side) * Spacing - HalfSize, 100.f);
+
+		const FTransform Transform(Location);
+
+		AInteractionBenchmarkActor* Actor = World->SpawnActorDeferred<AInteractionBenchmarkActor>(
+			AInteractionBenchmarkActor::StaticClass(), Transform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+		if (!Actor)
+		{
+			continue;
+		}
+
+		Actor->SettingsVariant = RandomStream.RandRange(0, AInteractionBenchmarkActor::NumSettingsVariants - 1);
+		Actor->FinishSpawning(Transform);
+
+		if (Actor->Interactable)
+		{
+			Actor->Interactable->SetPriority(RandomStream.RandRange(0, 255));
+		}
+	}
+
+	CsvPath = FPaths::ProfilingDir() / TEXT("InteractionNetBench") /
+		FString::Printf(TEXT("InteractionNetBench_%d_%s.csv"), InteractableCount, *FDateTime::Now().ToString());
+
+	FFileHelper::SaveStringToFile(
+		FString(TEXT("Time,Frames,AvgServerCpuMs,P99ServerCpuMs,MaxServerCpuMs,Connections,InBytes,OutBytes,ServerRPCs,ClientRPCs\n")),
+		*CsvPath);
+
+	UE_LOG(InteractionSystem, Display, TEXT("Interaction net benchmark spawned %d interactables, writing results to %s"),
+		InteractableCount, *CsvPath);
+}
+
+void UInteractionNetBenchmarkSubsystem::GatherConnections(TArray<FInteractionNetBenchConnection>& OutConnections) const
+{
+	OutConnections.Reset();
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+
+	if (!NetDriver)
+	{
+		return;
+	}
+
+	for (const UNetConnection* Connection : NetDriver->ClientConnections)
+	{
+		if (!Connection)
+		{
+			continue;
+		}
+
+		FInteractionNetBenchConnection& Entry = OutConnections.AddDefaulted_GetRef();
+		Entry.Name = Connection->LowLevelGetRemoteAddress(true);
+		Entry.InBytes = Connection->InTotalBytes;
+		Entry.OutBytes = Connection->OutTotalBytes;
+
+		const APawn* Pawn = Connection->PlayerController ? Connection->PlayerController->GetPawn() : nullptr;
+
+		if (const UPlayerInteractionComponent* PIC = Pawn ? Pawn->FindComponentByClass<UPlayerInteractionComponent>() : nullptr)
+		{
+			Entry.ServerRPCs = PIC->ServerRPCCount;
+			Entry.ClientRPCs = PIC->ClientRPCCount;
+		}
+	}
+}
+
+void UInteractionNetBenchmarkSubsystem::WriteReport(bool bFinal)
+{
+	if (CsvPath.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FInteractionNetBenchConnection> Connections;
+	GatherConnections(Connections);
+
+	float Sum = 0.f;
+	float Max = 0.f;
+
+	for (const float FrameTime : FrameTimesMs)
+	{
+		Sum += FrameTime;
+		Max = FMath::Max(Max, FrameTime);
+	}
+
+	float P99 = 0.f;
+
+	if (FrameTimesMs.Num())
+	{
+		TArray<float> Sorted = FrameTimesMs;
+		Sorted.Sort();
+		P99 = Sorted[FMath::Min(Sorted.Num() - 1, FMath::FloorToInt(Sorted.Num() * 0.99f))];
+	}
+
+	int64 InBytes = 0;
+	int64 OutBytes = 0;
+	uint32 ServerRPCs = 0;
+	uint32 ClientRPCs = 0;
+
+	// Deltas since the previous report, connections are matched by address
+	for (const FInteractionNetBenchConnection& Connection : Connections)
+	{
+		const FInteractionNetBenchConnection* Last = LastConnections.FindByPredicate(
+			[&Connection](const FInteractionNetBenchConnection& Other) { return Other.Name == Connection.Name; });
+
+		InBytes += Connection.InBytes - (Last ? Last->InBytes : 0);
+		OutBytes += Connection.OutBytes - (Last ? Last->OutBytes : 0);
+		ServerRPCs += Connection.ServerRPCs - (Last ? Last->ServerRPCs : 0);
+		ClientRPCs += Connection.ClientRPCs - (Last ? Last->ClientRPCs : 0);
+	}
+
+	FFileHelper::SaveStringToFile(FString::Printf(TEXT("%.2f,%d,%.3f,%.3f,%.3f,%d,%lld,%lld,%u,%u\n"), ElapsedTime,
+		FrameTimesMs.Num(), FrameTimesMs.Num() ? Sum / FrameTimesMs.Num() : 0.f, P99, Max, Connections.Num(),
+		InBytes, OutBytes, ServerRPCs, ClientRPCs), *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+		&IFileManager::Get(), FILEWRITE_Append);
+
+	FrameTimesMs.Reset();
+	LastConnections = Connections;
+
+	if (!bFinal)
+	{
+		return;
+	}
+
+	FString Summary(TEXT("Connection,InBytes,OutBytes,ServerRPCs,ClientRPCs\n"));
+
+	for (const FInteractionNetBenchConnection& Connection : Connections)
+	{
+		Summary += FString::Printf(TEXT("%s,%lld,%lld,%u,%u\n"), *Connection.Name, Connection.InBytes,
+			Connection.OutBytes, Connection.ServerRPCs, Connection.ClientRPCs);
+	}
+
+	FFileHelper::SaveStringToFile(Summary, *FPaths::ChangeExtension(CsvPath, TEXT("connections.csv")));
+
+	UE_LOG(InteractionSystem, Display, TEXT("Interaction net benchmark finished after %.1f s with %d connections."),
+		ElapsedTime, Connections.Num());
+}
+
+void UInteractionNetBenchmarkSubsystem::TickServer(float DeltaTime)
+{
+	if (!bStarted)
+	{
+		StartServer();
+		bStarted = true;
+		return;
+	}
+
+	// Game thread time without the idle time spent waiting for the server tick rate
+	FrameTimesMs.Add(static_cast<float>((FApp::GetDeltaTime() - FApp::GetIdleTime()) * 1000.0));
+
+	if (ElapsedTime >= NextReportTime)
+	{
+		WriteReport(false);
+		NextReportTime += 1.f;
+	}
+
+	if (ElapsedTime >= Duration)
+	{
+		WriteReport(true);
+		bFinished = true;
+
+		if (bExitWhenFinished)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+void UInteractionNetBenchmarkSubsystem::TickBot(float DeltaTime)
+{
+	APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+
+	if (!Pawn)
+	{
+		return;
+	}
+
+	UPlayerInteractionComponent* PIC = Pawn->FindComponentByClass<UPlayerInteractionComponent>();
+
+	if (!PIC)
+	{
+		return;
+	}
+
+	bStarted = true;
+
+	// Every bot follows its own deterministic circle through the field
+	const int32 Side = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(InteractableCount)));
+	const float HalfSize = Side * Spacing * 0.5f;
+	const float Radius = HalfSize * (0.2f + 0.7f * FMath::Frac(BotIndex * 0.618034f));
+	const float Angle = ElapsedTime * 0.2f + BotIndex * 2.399963f;
+
+	const FVector Target(FMath::Cos(Angle) * Radius, FMath::Sin(Angle) * Radius, 100.f);
+
+	Pawn->AddMovementInput((Target - Pawn->GetActorLocation()).GetSafeNormal());
+
+	if (ElapsedTime >= NextBotInteractionTime)
+	{
+		PIC->InteractWithInteractablesOnServer();
+		NextBotInteractionTime = ElapsedTime + RandomStream.FRandRange(1.5f, 2.5f);
+	}
+	else if (NextBotInteractionTime - ElapsedTime < 0.5f)
+	{
+		PIC->StopInteraction();
+	}
+
+	if (ElapsedTime >= Duration && bExitWhenFinished)
+	{
+		bFinished = true;
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UInteractionNetBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	ElapsedTime += DeltaTime;
+
+	if (bIsBot)
+	{
+		TickBot(DeltaTime);
+	}
+	else if (GetWorld()->GetNetMode() != NM_Client)
+	{
+		TickServer(DeltaTime);
+	}
+}
+
+bool UInteractionNetBenchmarkSubsystem::IsTickable() const
+{
+	return bInitialized && !bFinished && !IsTemplate() && GetWorld() && GetWorld()->IsGameWorld()
+		&& GetWorld()->HasBegunPlay();
+}
+
+TStatId UInteractionNetBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionNetBenchmarkSubsystem, STATGROUP_InteractionSystem);
+}
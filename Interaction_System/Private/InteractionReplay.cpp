@@ -0,0 +1,117 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionReplay.h"
+#include "InteractionLog.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FString FInteractionReplay::GetReplayPath(const FString& Filename)
+{
+	return FPaths::IsRelative(Filename) ? FPaths::ProfilingDir() / TEXT("InteractionReplays") / Filename : Filename;
+}
+
+bool FInteractionReplay::SaveToFile(const FString& Filename)
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	Serialize(Writer);
+
+	return FFileHelper::SaveArrayToFile(Data, *GetReplayPath(Filename));
+}
+
+bool FInteractionReplay::LoadFromFile(const FString& Filename)
+{
+	TArray<uint8> Data;
+
+	if (!FFileHelper::LoadFileToArray(Data, *GetReplayPath(Filename)))
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interaction replay %s couldn't be read."), *GetReplayPath(Filename));
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	Serialize(Reader);
+
+	if (Reader.IsError())
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interaction replay %s is not a valid replay of version %d."),
+			*GetReplayPath(Filename), Version);
+		Frames.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+void FInteractionReplay::Serialize(FArchive& Ar)
+{
+	uint32 FileMagic = Magic;
+	int32 FileVersion = Version;
+
+	Ar << FileMagic;
+	Ar << FileVersion;
+
+	if (FileMagic != Magic || FileVersion != Version)
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << RandomSeed;
+	Ar << MapName;
+
+	int32 NumFrames = Frames.Num();
+	Ar << NumFrames;
+
+	if (Ar.IsLoading())
+	{
+		if (NumFrames < 0 || NumFrames > Ar.TotalSize())
+		{
+			Ar.SetError();
+			return;
+		}
+
+		Frames.SetNum(NumFrames);
+	}
+
+	for (FInteractionReplayFrame& Frame : Frames)
+	{
+		Ar << Frame.DeltaTime;
+
+		uint8 NumPlayers = static_cast<uint8>(Frame.Players.Num());
+		Ar << NumPlayers;
+
+		if (Ar.IsLoading())
+		{
+			Frame.Players.SetNum(NumPlayers);
+		}
+
+		for (FInteractionReplayPlayer& Player : Frame.Players)
+		{
+			Ar << Player.Location;
+			Player.Rotation.SerializeCompressedShort(Ar);
+			Player.ControlRotation.SerializeCompressedShort(Ar);
+
+			uint8 NumInputs = static_cast<uint8>(Player.Inputs.Num());
+			Ar << NumInputs;
+
+			if (Ar.IsLoading())
+			{
+				Player.Inputs.SetNum(NumInputs);
+			}
+
+			for (EInteractionReplayInput& Input : Player.Inputs)
+			{
+				Ar << Input;
+			}
+		}
+
+		if (Ar.IsError())
+		{
+			return;
+		}
+	}
+}
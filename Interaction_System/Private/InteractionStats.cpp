@@ -0,0 +1,22 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionStats.h"
+
+DEFINE_STAT(STAT_InteractionTraces);
+DEFINE_STAT(STAT_InteractionCreateWidget);
+DEFINE_STAT(STAT_InteractionSubscribedPairs);
+DEFINE_STAT(STAT_InteractionCandidates);
+
+#if !UE_BUILD_SHIPPING
+
+bool FInteractionBenchmarkCounters::bEnabled = false;
+
+int32 FInteractionBenchmarkCounters::ScopeDepth = 0;
+
+uint64 FInteractionBenchmarkCounters::Cycles = 0;
+
+TAtomic<uint32> FInteractionBenchmarkCounters::Traces(0);
+
+uint32 FInteractionBenchmarkCounters::CreatedWidgets = 0;
+
+#endif //!UE_BUILD_SHIPPING
@@ -0,0 +1,2090 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionSubsystem.h"
+#include "InteractableComponent.h"
+#include "PlayerInteractionComponent.h"
+#include "InteractableDefinition.h"
+#include "InteractionStats.h"
+#include "InteractionTrace.h"
+#include "InteractionLog.h"
+#include "InteractionMemory.h"
+#include "InteractionReplay.h"
+#include "InteractionEvaluation.h"
+#include "InteractableClusterComponent.h"
+#include "InstancedInteractableComponent.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/SphereComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PawnMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "UObject/UObjectIterator.h"
+
+DECLARE_CYCLE_STAT(TEXT("Process Interaction Requests"), STAT_InteractionProcessRequests, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Interaction Queue Depth"), STAT_InteractionQueueDepth, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Rejected Interactions"), STAT_InteractionRejected, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Update Server Candidates"), STAT_InteractionUpdateServerCandidates, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Registry Component Lookups"), STAT_InteractionRegistryLookups, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("FindComponentByClass Lookups"), STAT_InteractionFindComponentLookups, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Flush Moved Interactables"), STAT_InteractionFlushMoved, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Moved Interactables"), STAT_InteractionMovedInteractables, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dynamic Interactables"), STAT_InteractionDynamicInteractables, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Streamed In Interactables"), STAT_InteractionStreamedIn, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Streamed Out Interactables"), STAT_InteractionStreamedOut, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Resolve Initial Overlaps"), STAT_InteractionInitialOverlaps, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Initial Overlaps"), STAT_InteractionPendingOverlaps, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Selections"), STAT_InteractionEvaluateSelections, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Selections Gather"), STAT_InteractionEvaluateGather, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Selections Evaluate"), STAT_InteractionEvaluateJobs, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Evaluate Selections Apply"), STAT_InteractionEvaluateApply, STATGROUP_InteractionSystem);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Evaluated Candidates"), STAT_InteractionEvaluatedCandidates, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Flush Events"), STAT_InteractionFlushEvents, STATGROUP_InteractionSystem);
+
+DECLARE_STATS_GROUP(TEXT("InteractionLatency"), STATGROUP_InteractionLatency, STATCAT_Advanced);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input P50 (ms)"), STAT_InteractionLatencyInputP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input P95 (ms)"), STAT_InteractionLatencyInputP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Input P99 (ms)"), STAT_InteractionLatencyInputP99, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Hold P50 (ms)"), STAT_InteractionLatencyHoldP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Hold P95 (ms)"), STAT_InteractionLatencyHoldP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Hold P99 (ms)"), STAT_InteractionLatencyHoldP99, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Queue P50 (ms)"), STAT_InteractionLatencyQueueP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Queue P95 (ms)"), STAT_InteractionLatencyQueueP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Queue P99 (ms)"), STAT_InteractionLatencyQueueP99, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Execute P50 (ms)"), STAT_InteractionLatencyExecuteP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Execute P95 (ms)"), STAT_InteractionLatencyExecuteP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Execute P99 (ms)"), STAT_InteractionLatencyExecuteP99, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network P50 (ms)"), STAT_InteractionLatencyNetworkP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network P95 (ms)"), STAT_InteractionLatencyNetworkP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Network P99 (ms)"), STAT_InteractionLatencyNetworkP99, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total P50 (ms)"), STAT_InteractionLatencyTotalP50, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total P95 (ms)"), STAT_InteractionLatencyTotalP95, STATGROUP_InteractionLatency);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Total P99 (ms)"), STAT_InteractionLatencyTotalP99, STATGROUP_InteractionLatency);
+
+CSV_DEFINE_CATEGORY(InteractionLatency, false);
+
+static TAutoConsoleVariable<int32> CVarServerCandidateTracking(
+	TEXT("Interaction.ServerCandidateTracking"),
+	1,
+	TEXT("If 1 the server tracks which interactables are in range of every player using a spatial grid."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarComponentRegistry(
+	TEXT("Interaction.ComponentRegistry"),
+	1,
+	TEXT("If 1 interaction components are looked up through the per-world registry, if 0 FindComponentByClass is used."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSpatialGridCellSize(
+	TEXT("Interaction.SpatialGridCellSize"),
+	1000.f,
+	TEXT("Cell size of the interaction spatial grid, read when the world is created."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarInitialOverlapBudgetMs(
+	TEXT("Interaction.InitialOverlapBudgetMs"),
+	1.f,
+	TEXT("Time per frame spent resolving initial player/interactable overlaps, the rest is resolved next frame. 0 means unlimited."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarInitialOverlapDelay(
+	TEXT("Interaction.InitialOverlapDelay"),
+	0.2f,
+	TEXT("Seconds after BeginPlay of an interactable before players already inside its sphere are added."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarLatencyTelemetry(
+	TEXT("Interaction.LatencyTelemetry"),
+	0,
+	TEXT("If 1 every interaction is timestamped and the latency of its stages is recorded, see Interaction.DumpLatency. Has to be set on the server and the clients."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDebugOverlay(
+	TEXT("Interaction.DebugOverlay"),
+	0,
+	TEXT("Draws the results of the local players' interaction evaluation. 0: off, 1: table of candidates, 2: label per candidate. Replaces the per-interactable debug strings while enabled."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarRandomSeed(
+	TEXT("Interaction.RandomSeed"),
+	0,
+	TEXT("If not 0 randomized interactable priorities and rarities are seeded with this value, read when the world is created. Replays always use the seed of their recording."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarParallelEvaluation(
+	TEXT("Interaction.ParallelEvaluation"),
+	1,
+	TEXT("If 1 the candidates of every player are evaluated in one batch after physics, before the interaction components tick, spread over the task graph workers. If 0 every player evaluates its candidates on the game thread when they are first needed."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarParallelEvaluationMinJobs(
+	TEXT("Interaction.ParallelEvaluationMinJobs"),
+	64,
+	TEXT("Evaluation batches with fewer candidates stay on the game thread, the task overhead would outweigh the work."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDeferredEvents(
+	TEXT("Interaction.DeferredEvents"),
+	1,
+	TEXT("If 1 subscription, selection and can interact delegates are queued, coalesced and broadcasted once at the end of the frame. If 0 they are broadcasted when raised."),
+	ECVF_Default);
+
+static const TCHAR* GetLatencyStageName(EInteractionLatencyStage Stage)
+{
+	switch (Stage)
+	{
+	case EInteractionLatencyStage::Input:
+		return TEXT("Input");
+	case EInteractionLatencyStage::Hold:
+		return TEXT("Hold");
+	case EInteractionLatencyStage::Queue:
+		return TEXT("Queue");
+	case EInteractionLatencyStage::Execute:
+		return TEXT("Execute");
+	case EInteractionLatencyStage::Network:
+		return TEXT("Network");
+	case EInteractionLatencyStage::Total:
+		return TEXT("Total");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+static void DumpInteractionLatency(const TArray<FString>& Args)
+{
+	const bool bReset = Args.Contains(TEXT("Reset"));
+
+	// Every game world, PIE clients and the PIE server each record their own side of the interactions
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		UInteractionSubsystem* Subsystem = World && World->IsGameWorld()
+			? World->GetSubsystem<UInteractionSubsystem>() : nullptr;
+
+		if (!Subsystem)
+		{
+			continue;
+		}
+
+		const ENetMode NetMode = World->GetNetMode();
+
+		UE_LOG(InteractionSystem, Display, TEXT("Interaction latency of %s (%s):"), *World->GetName(),
+			NetMode == NM_Client ? TEXT("client") : NetMode == NM_Standalone ? TEXT("standalone") : TEXT("server"));
+
+		for (int32 Index = 0; Index < static_cast<int32>(EInteractionLatencyStage::MAX); ++Index)
+		{
+			const EInteractionLatencyStage Stage = static_cast<EInteractionLatencyStage>(Index);
+			const FInteractionLatencyHistogram& Histogram = Subsystem->GetLatencyHistogram(Stage);
+
+			UE_LOG(InteractionSystem, Display,
+				TEXT("  %-8s samples %5u  mean %7.2f ms  p50 %7.2f ms  p95 %7.2f ms  p99 %7.2f ms  max %7.2f ms"),
+				GetLatencyStageName(Stage), Histogram.Num(), Histogram.GetMean(), Histogram.GetPercentile(0.5f),
+				Histogram.GetPercentile(0.95f), Histogram.GetPercentile(0.99f), Histogram.GetMax());
+		}
+
+		if (bReset)
+		{
+			Subsystem->ResetLatencyHistograms();
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdDumpInteractionLatency(
+	TEXT("Interaction.DumpLatency"),
+	TEXT("Logs p50/p95/p99 of every interaction latency stage for each game world. Args: [Reset]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpInteractionLatency));
+
+static void StartInteractionRecording(const TArray<FString>& Args, UWorld* World)
+{
+	if (UInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->StartRecording(Args.Num() ? Args[0] : FString::Printf(TEXT("%s_%s.ireplay"),
+			*UWorld::RemovePIEPrefix(World->GetMapName()), *FDateTime::Now().ToString()));
+	}
+}
+
+static void StopInteractionRecording(const TArray<FString>& Args, UWorld* World)
+{
+	if (UInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->StopRecording();
+	}
+}
+
+static void StartInteractionReplay(const TArray<FString>& Args, UWorld* World)
+{
+	UInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UInteractionSubsystem>() : nullptr;
+
+	if (Subsystem && Args.Num())
+	{
+		Subsystem->StartReplay(Args[0]);
+	}
+}
+
+static void StopInteractionReplay(const TArray<FString>& Args, UWorld* World)
+{
+	if (UInteractionSubsystem* Subsystem = World ? World->GetSubsystem<UInteractionSubsystem>() : nullptr)
+	{
+		Subsystem->StopReplay();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdStartInteractionRecording(
+	TEXT("Interaction.Record"),
+	TEXT("Records the local players' transforms, control rotations and interaction inputs. Optional file name, written to Saved/Profiling/InteractionReplays by Interaction.StopRecording."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartInteractionRecording));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdStopInteractionRecording(
+	TEXT("Interaction.StopRecording"),
+	TEXT("Stops the interaction recording and writes it to its file."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StopInteractionRecording));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdStartInteractionReplay(
+	TEXT("Interaction.Replay"),
+	TEXT("Replays an interaction recording: Interaction.Replay <File>. Also started on world creation by -InteractionReplay=<File>, -InteractionReplayExit quits once it finished."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StartInteractionReplay));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdStopInteractionReplay(
+	TEXT("Interaction.StopReplay"),
+	TEXT("Stops the running interaction replay."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&StopInteractionReplay));
+
+UInteractionSubsystem* UInteractionSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!WorldContextObject)
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = WorldContextObject->GetWorld();
+
+	return World ? World->GetSubsystem<UInteractionSubsystem>() : nullptr;
+}
+
+void UInteractionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SpatialGrid = TInteractionSpatialGrid<FInteractionGridEntry>(CVarSpatialGridCellSize.GetValueOnGameThread());
+	DynamicGrid = TInteractionSpatialGrid<FInteractionGridEntry>(CVarSpatialGridCellSize.GetValueOnGameThread());
+	LightweightGrid = TInteractionSpatialGrid<FInteractionHandle>(CVarSpatialGridCellSize.GetValueOnGameThread());
+
+#if !UE_BUILD_SHIPPING
+	if (!IsRunningDedicatedServer())
+	{
+		DebugDrawHandle = UDebugDrawService::Register(TEXT("Game"),
+			FDebugDrawDelegate::CreateUObject(this, &UInteractionSubsystem::DrawDebugOverlay));
+	}
+#endif //!UE_BUILD_SHIPPING
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UInteractionSubsystem::OnLevelAddedToWorld);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this,
+		&UInteractionSubsystem::OnLevelRemovedFromWorld);
+
+	bInitialized = true;
+
+	// Seeded before any interactable begins play
+	if (GetWorld() && GetWorld()->IsGameWorld())
+	{
+		FString ReplayFilename;
+		FString RecordFilename;
+
+		if (FParse::Value(FCommandLine::Get(), TEXT("InteractionReplay="), ReplayFilename))
+		{
+			StartReplay(ReplayFilename);
+		}
+		else if (FParse::Value(FCommandLine::Get(), TEXT("InteractionRecord="), RecordFilename))
+		{
+			StartRecording(RecordFilename);
+		}
+		else if (CVarRandomSeed.GetValueOnGameThread() != 0)
+		{
+			SetRandomSeed(CVarRandomSeed.GetValueOnGameThread());
+		}
+	}
+}
+
+void UInteractionSubsystem::Deinitialize()
+{
+	bInitialized = false;
+
+	StopRecording();
+	StopReplay();
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	if (EvaluationTickFunction.IsTickFunctionRegistered())
+	{
+		EvaluationTickFunction.UnRegisterTickFunction();
+	}
+
+	if (DebugDrawHandle.IsValid())
+	{
+		UDebugDrawService::Unregister(DebugDrawHandle);
+		DebugDrawHandle.Reset();
+	}
+
+	PendingRequests.Empty();
+	ProcessingRequests.Empty();
+	ClaimedInteractables.Empty();
+	SpatialGrid.Empty();
+	DynamicGrid.Empty();
+	MovedInteractables.Empty();
+	TrackedPlayers.Empty();
+	RegisteredPlayers.Empty();
+	StreamedInInteractables.Empty();
+	StreamedOutInteractables.Empty();
+	PendingOverlapChecks.Empty();
+	ActorComponents.Empty();
+	LightweightStore.Empty();
+	LightweightGrid.Empty();
+	LightweightDefinitions.Empty();
+	ClaimedLightweight.Empty();
+	EvaluationViews.Empty();
+	EvaluationJobs.Empty();
+	EvaluationBatch.Empty();
+	EventQueue.Reset();
+
+	Super::Deinitialize();
+}
+
+void UInteractionSubsystem::EnqueueInteraction(UPlayerInteractionComponent* Player,
+	UInteractableComponent* Interactable, float ClientTimeStamp, double ReceiveTime)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Player || !Interactable)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Player or Interactable passed to EnqueueInteraction() is nullptr."));
+		return;
+	}
+
+	FInteractionRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Player = Player;
+	Request.Interactable = Interactable;
+	Request.ClientTimeStamp = ClientTimeStamp;
+
+	if (IsLatencyTelemetryEnabled())
+	{
+		Request.ReceiveTime = ReceiveTime;
+		Request.EnqueueTime = FPlatformTime::Seconds();
+	}
+}
+
+void UInteractionSubsystem::EnqueueLightweightInteraction(UPlayerInteractionComponent* Player,
+	const FInteractionHandle& Handle, float ClientTimeStamp)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Player || !Handle.IsValid())
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Player or Handle passed to EnqueueLightweightInteraction() is invalid."));
+		return;
+	}
+
+	FInteractionRequest& Request = PendingRequests.AddDefaulted_GetRef();
+	Request.Player = Player;
+	Request.LightweightHandle = Handle;
+	Request.ClientTimeStamp = ClientTimeStamp;
+}
+
+void UInteractionSubsystem::ProcessInteractionRequests()
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionProcessRequests);
+	TRACE_INTERACTION_SCOPE(Interaction_ProcessRequests);
+
+	const int32 QueueDepth = PendingRequests.Num();
+
+	QueueMetrics.LastQueueDepth = QueueDepth;
+	QueueMetrics.PeakQueueDepth = FMath::Max(QueueMetrics.PeakQueueDepth, QueueDepth);
+	SET_DWORD_STAT(STAT_InteractionQueueDepth, QueueDepth);
+
+	if (!QueueDepth)
+	{
+		QueueMetrics.LastProcessingTimeMs = 0.f;
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Requests queued by Interact handlers during processing are executed in the next batch
+	Swap(PendingRequests, ProcessingRequests);
+	ClaimedInteractables.Reset();
+	ClaimedLightweight.Reset();
+
+	int32 Executed = 0;
+	int32 Rejected = 0;
+
+	for (const FInteractionRequest& Request : ProcessingRequests)
+	{
+		UPlayerInteractionComponent* Player = Request.Player.Get();
+		UInteractableComponent* Interactable = Request.Interactable.Get();
+
+		if (Player && Request.LightweightHandle.IsValid())
+		{
+			if (ProcessLightweightRequest(Request, Player))
+			{
+				++Executed;
+			}
+			else
+			{
+				++Rejected;
+			}
+
+			continue;
+		}
+
+		if (!Player || !Interactable)
+		{
+			continue;
+		}
+
+		// First valid request for an interactable wins, the rest of the batch is rejected
+		if (ClaimedInteractables.Contains(Interactable))
+		{
+			Player->RejectInteraction(Interactable, EInteractionRejectReason::AlreadyClaimed);
+			++Rejected;
+			continue;
+		}
+
+		if (!Player->ValidateInteractionAtTime(Interactable, Request.ClientTimeStamp))
+		{
+			Player->RejectInteraction(Interactable, EInteractionRejectReason::NotUsable);
+			++Rejected;
+			continue;
+		}
+
+		if (Request.EnqueueTime > 0.0)
+		{
+			RecordLatency(EInteractionLatencyStage::Queue,
+				static_cast<float>((FPlatformTime::Seconds() - Request.EnqueueTime) * 1000.0));
+		}
+
+		ClaimedInteractables.Add(Interactable);
+		Player->ExecuteInteract(Interactable);
+		++Executed;
+
+		if (Request.ReceiveTime > 0.0)
+		{
+			Player->ConfirmInteraction(Interactable, Request.ReceiveTime);
+		}
+	}
+
+	// Requests whose player or interactable was destroyed while queued count as neither
+	QueueMetrics.ExecutedRequests += Executed;
+	QueueMetrics.RejectedRequests += Rejected;
+	INC_DWORD_STAT_BY(STAT_InteractionRejected, Rejected);
+
+	ProcessingRequests.Reset();
+
+	QueueMetrics.LastProcessingTimeMs = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	QueueMetrics.PeakProcessingTimeMs = FMath::Max(QueueMetrics.PeakProcessingTimeMs,
+		QueueMetrics.LastProcessingTimeMs);
+}
+
+bool UInteractionSubsystem::ProcessLightweightRequest(const FInteractionRequest& Request,
+	UPlayerInteractionComponent* Player)
+{
+	const FInteractionHandle& Handle = Request.LightweightHandle;
+
+	if (ClaimedLightweight.Contains(Handle))
+	{
+		Player->RejectInteraction(nullptr, EInteractionRejectReason::AlreadyClaimed);
+		return false;
+	}
+
+	if (!Player->ValidateLightweightAtTime(Handle, Request.ClientTimeStamp))
+	{
+		Player->RejectInteraction(nullptr, EInteractionRejectReason::NotUsable);
+		return false;
+	}
+
+	ClaimedLightweight.Add(Handle);
+	ExecuteLightweightInteraction(Player, Handle);
+
+	return true;
+}
+
+void UInteractionSubsystem::ResetQueueMetrics()
+{
+	QueueMetrics = FInteractionQueueMetrics();
+}
+
+bool UInteractionSubsystem::IsServerCandidateTrackingEnabled()
+{
+	return CVarServerCandidateTracking.GetValueOnGameThread() != 0;
+}
+
+void UInteractionSubsystem::RegisterInteractable(UInteractableComponent* Interactable)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Interactable)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interactable passed to RegisterInteractable() is nullptr."));
+		return;
+	}
+
+	if (Interactable->SpatialGridIndex != INDEX_NONE)
+	{
+		return;
+	}
+
+	const float Radius = Interactable->SphereComponent ? Interactable->SphereComponent->GetScaledSphereRadius()
+		: Interactable->GetSettings().MaximumDistanceToPlayer;
+
+	FInteractionGridEntry Entry;
+	Entry.Component = Interactable;
+
+	// Everything starts static, interactables are promoted when they move for the first time
+	Interactable->SpatialGridIndex = SpatialGrid.Add(Interactable->GetComponentLocation(), Radius, Entry);
+	Interactable->bInDynamicSpatialGrid = false;
+	Interactable->bSpatialGridDirty = false;
+}
+
+void UInteractionSubsystem::UnregisterInteractable(UInteractableComponent* Interactable)
+{
+	if (!Interactable || Interactable->SpatialGridIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (Interactable->bInDynamicSpatialGrid)
+	{
+		DynamicGrid.Remove(Interactable->SpatialGridIndex);
+	}
+	else
+	{
+		SpatialGrid.Remove(Interactable->SpatialGridIndex);
+	}
+
+	Interactable->SpatialGridIndex = INDEX_NONE;
+	Interactable->bInDynamicSpatialGrid = false;
+	Interactable->bSpatialGridDirty = false;
+}
+
+void UInteractionSubsystem::NotifyInteractableMoved(UInteractableComponent* Interactable)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Interactable || Interactable->SpatialGridIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (!Interactable->bInDynamicSpatialGrid)
+	{
+		const float Radius = Interactable->SphereComponent ? Interactable->SphereComponent->GetScaledSphereRadius()
+			: Interactable->GetSettings().MaximumDistanceToPlayer;
+
+		FInteractionGridEntry Entry;
+		Entry.Component = Interactable;
+
+		SpatialGrid.Remove(Interactable->SpatialGridIndex);
+		Interactable->SpatialGridIndex = DynamicGrid.Add(Interactable->GetComponentLocation(), Radius, Entry);
+		Interactable->bInDynamicSpatialGrid = true;
+		return;
+	}
+
+	if (!Interactable->bSpatialGridDirty)
+	{
+		Interactable->bSpatialGridDirty = true;
+		MovedInteractables.Add(Interactable);
+	}
+}
+
+void UInteractionSubsystem::FlushMovedInteractables()
+{
+	INTERACTION_LLM_SCOPE(Caches);
+	SCOPE_CYCLE_COUNTER(STAT_InteractionFlushMoved);
+	TRACE_INTERACTION_SCOPE(Interaction_FlushMovedInteractables);
+
+	SET_DWORD_STAT(STAT_InteractionMovedInteractables, MovedInteractables.Num());
+	SET_DWORD_STAT(STAT_InteractionDynamicInteractables, DynamicGrid.Num());
+
+	for (const auto& Moved : MovedInteractables)
+	{
+		UInteractableComponent* Interactable = Moved.Get();
+
+		// Unregistered or re-registered since it was queued
+		if (!Interactable || !Interactable->bSpatialGridDirty)
+		{
+			continue;
+		}
+
+		Interactable->bSpatialGridDirty = false;
+		DynamicGrid.Update(Interactable->SpatialGridIndex, Interactable->GetComponentLocation());
+	}
+
+	MovedInteractables.Reset();
+}
+
+void UInteractionSubsystem::RegisterPlayer(UPlayerInteractionComponent* Player)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (Player)
+	{
+		TrackedPlayers.AddUnique(Player);
+	}
+}
+
+void UInteractionSubsystem::UnregisterPlayer(UPlayerInteractionComponent* Player)
+{
+	TrackedPlayers.RemoveSingleSwap(Player, false);
+}
+
+int32 UInteractionSubsystem::AllocatePlayerIndex()
+{
+	if (UsedPlayerIndices == MAX_uint64)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 PlayerIndex = static_cast<int32>(FMath::CountTrailingZeros64(~UsedPlayerIndices));
+	UsedPlayerIndices |= 1ull << PlayerIndex;
+
+	return PlayerIndex;
+}
+
+void UInteractionSubsystem::ReleasePlayerIndex(int32 PlayerIndex)
+{
+	if (PlayerIndex >= 0 && PlayerIndex < 64)
+	{
+		UsedPlayerIndices &= ~(1ull << PlayerIndex);
+	}
+}
+
+bool UInteractionSubsystem::IsComponentRegistryEnabled()
+{
+	// Also read by the reachability traces of the parallel evaluation
+	return CVarComponentRegistry.GetValueOnAnyThread() != 0;
+}
+
+void UInteractionSubsystem::RegisterComponent(UInteractableComponent* Component)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Component || !Component->GetOwner())
+	{
+		return;
+	}
+
+	FInteractionActorComponents& Components = ActorComponents.FindOrAdd(Component->GetOwner());
+
+	if (!Components.Interactable.IsValid())
+	{
+		Components.Interactable = Component;
+	}
+
+	AddEvaluationPrerequisite(Component->PrimaryComponentTick);
+}
+
+void UInteractionSubsystem::UnregisterComponent(UInteractableComponent* Component)
+{
+	if (!Component || !Component->GetOwner())
+	{
+		return;
+	}
+
+	RemoveEvaluationPrerequisite(Component->PrimaryComponentTick);
+
+	FInteractionActorComponents* Components = ActorComponents.Find(Component->GetOwner());
+
+	if (!Components || Components->Interactable.Get() != Component)
+	{
+		return;
+	}
+
+	// Another interactable component on the same actor takes over
+	Components->Interactable = nullptr;
+
+	TInlineComponentArray<UInteractableComponent*> Interactables(Component->GetOwner());
+
+	for (UInteractableComponent* Other : Interactables)
+	{
+		if (Other != Component && Other->IsRegistered())
+		{
+			Components->Interactable = Other;
+			break;
+		}
+	}
+
+	if (!Components->Interactable.IsValid() && !Components->Player.IsValid())
+	{
+		ActorComponents.Remove(Component->GetOwner());
+	}
+}
+
+void UInteractionSubsystem::RegisterComponent(UPlayerInteractionComponent* Component)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Component || !Component->GetOwner())
+	{
+		return;
+	}
+
+	FInteractionActorComponents& Components = ActorComponents.FindOrAdd(Component->GetOwner());
+
+	if (!Components.Player.IsValid())
+	{
+		Components.Player = Component;
+	}
+
+	RegisteredPlayers.AddUnique(Component);
+
+	AddEvaluationPrerequisite(Component->PrimaryComponentTick);
+}
+
+void UInteractionSubsystem::UnregisterComponent(UPlayerInteractionComponent* Component)
+{
+	if (!Component || !Component->GetOwner())
+	{
+		return;
+	}
+
+	RegisteredPlayers.RemoveSingleSwap(Component, false);
+	RemoveEvaluationPrerequisite(Component->PrimaryComponentTick);
+
+	FInteractionActorComponents* Components = ActorComponents.Find(Component->GetOwner());
+
+	if (!Components || Components->Player.Get() != Component)
+	{
+		return;
+	}
+
+	Components->Player = nullptr;
+
+	if (!Components->Interactable.IsValid())
+	{
+		ActorComponents.Remove(Component->GetOwner());
+	}
+}
+
+UInteractableComponent* UInteractionSubsystem::FindInteractableComponent(const AActor* Actor)
+{
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	if (IsComponentRegistryEnabled())
+	{
+		if (const UInteractionSubsystem* Subsystem = Get(Actor))
+		{
+			INC_DWORD_STAT(STAT_InteractionRegistryLookups);
+
+			const FInteractionActorComponents* Components = Subsystem->ActorComponents.Find(Actor);
+
+			return Components ? Components->Interactable.Get() : nullptr;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_InteractionFindComponentLookups);
+
+	return Actor->FindComponentByClass<UInteractableComponent>();
+}
+
+UPlayerInteractionComponent* UInteractionSubsystem::FindPlayerInteractionComponent(const AActor* Actor)
+{
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	if (IsComponentRegistryEnabled())
+	{
+		if (const UInteractionSubsystem* Subsystem = Get(Actor))
+		{
+			INC_DWORD_STAT(STAT_InteractionRegistryLookups);
+
+			const FInteractionActorComponents* Components = Subsystem->ActorComponents.Find(Actor);
+
+			return Components ? Components->Player.Get() : nullptr;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_InteractionFindComponentLookups);
+
+	return Actor->FindComponentByClass<UPlayerInteractionComponent>();
+}
+
+bool UInteractionSubsystem::IsInStreamedLevel(const UActorComponent* Component)
+{
+	const ULevel* Level = Component && Component->GetOwner() ? Component->GetOwner()->GetLevel() : nullptr;
+
+	return Level && !Level->IsPersistentLevel();
+}
+
+void UInteractionSubsystem::QueueStreamedInInteractable(UInteractableComponent* Interactable)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Interactable)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interactable passed to QueueStreamedInInteractable() is nullptr."));
+		return;
+	}
+
+	StreamedInInteractables.Add(Interactable);
+}
+
+void UInteractionSubsystem::QueueStreamedOutInteractable(UInteractableComponent* Interactable)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Interactable)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interactable passed to QueueStreamedOutInteractable() is nullptr."));
+		return;
+	}
+
+	StreamedOutInteractables.Add(Interactable);
+}
+
+void UInteractionSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	// Actors of the level have begun play by now unless the world itself has not
+	if (World == GetWorld())
+	{
+		FlushStreamedInInteractables();
+	}
+}
+
+void UInteractionSubsystem::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	// Broadcasted after EndPlay of every actor in the level
+	if (World == GetWorld())
+	{
+		FlushStreamedOutInteractables();
+	}
+}
+
+void UInteractionSubsystem::FlushStreamedInInteractables()
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!StreamedInInteractables.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionStreamedIn);
+	TRACE_INTERACTION_SCOPE(Interaction_StreamedIn);
+
+	TArray<UInteractableComponent*> Interactables;
+	Interactables.Reserve(StreamedInInteractables.Num());
+
+	for (const auto& Streamed : StreamedInInteractables)
+	{
+		if (Streamed.IsValid() && Streamed->HasBegunPlay())
+		{
+			Interactables.Add(Streamed.Get());
+		}
+	}
+
+	StreamedInInteractables.Reset();
+
+	const bool bTrackCandidates = IsServerCandidateTrackingEnabled() && GetWorld()->GetNetMode() != NM_Client;
+
+	if (bTrackCandidates)
+	{
+		SpatialGrid.Reserve(SpatialGrid.Num() + Interactables.Num());
+
+		for (UInteractableComponent* Interactable : Interactables)
+		{
+			RegisterInteractable(Interactable);
+		}
+	}
+
+	// Overlap events aren't generated for streamed in actors, players already inside are found right away
+	for (UInteractableComponent* Interactable : Interactables)
+	{
+		QueueInitialOverlapCheck(Interactable, 0.f);
+	}
+
+	ResolveInitialOverlaps();
+}
+
+void UInteractionSubsystem::FlushStreamedOutInteractables()
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!StreamedOutInteractables.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionStreamedOut);
+	TRACE_INTERACTION_SCOPE(Interaction_StreamedOut);
+
+	TSet<const UInteractableComponent*> Interactables;
+	Interactables.Reserve(StreamedOutInteractables.Num());
+
+	for (const auto& Streamed : StreamedOutInteractables)
+	{
+		if (UInteractableComponent* Interactable = Streamed.Get())
+		{
+			UnregisterInteractable(Interactable);
+			Interactables.Add(Interactable);
+		}
+	}
+
+	StreamedOutInteractables.Reset();
+
+	// Also drops candidates that were already garbage collected
+	for (const auto& Player : RegisteredPlayers)
+	{
+		if (Player.IsValid())
+		{
+			Player->RemoveInteractables(Interactables);
+		}
+	}
+}
+
+void UInteractionSubsystem::QueueInitialOverlapCheck(UInteractableComponent* Interactable, float Delay)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Interactable)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interactable passed to QueueInitialOverlapCheck() is nullptr."));
+		return;
+	}
+
+	FPendingOverlapCheck Check;
+	Check.Interactable = Interactable;
+	Check.DueTime = GetWorld()->GetTimeSeconds() + (Delay < 0.f ? CVarInitialOverlapDelay.GetValueOnGameThread() : Delay);
+
+	PendingOverlapChecks.HeapPush(Check);
+}
+
+void UInteractionSubsystem::ResolveInitialOverlaps()
+{
+	if (!PendingOverlapChecks.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionInitialOverlaps);
+	TRACE_INTERACTION_SCOPE(Interaction_ResolveInitialOverlaps);
+
+	struct FLocalPlayer
+	{
+		UPlayerInteractionComponent* Player;
+
+		FVector Location;
+
+		float Radius;
+	};
+
+	TArray<FLocalPlayer, TInlineAllocator<4>> LocalPlayers;
+
+	for (const auto& PlayerPtr : RegisteredPlayers)
+	{
+		UPlayerInteractionComponent* Player = PlayerPtr.Get();
+		const APawn* Pawn = Player ? Cast<APawn>(Player->GetOwner()) : nullptr;
+
+		if (Pawn && Pawn->IsLocallyControlled())
+		{
+			LocalPlayers.Add({ Player, Pawn->GetActorLocation(), Pawn->GetSimpleCollisionRadius() });
+		}
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const double Budget = CVarInitialOverlapBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Resolved = 0; PendingOverlapChecks.Num(); ++Resolved)
+	{
+		if (PendingOverlapChecks.HeapTop().DueTime > Now)
+		{
+			break;
+		}
+
+		// Reading the clock for every check would cost more than most checks
+		if (Budget > 0.0 && (Resolved & 63) == 63 && FPlatformTime::Seconds() - StartTime > Budget)
+		{
+			break;
+		}
+
+		FPendingOverlapCheck Check;
+		PendingOverlapChecks.HeapPop(Check, false);
+
+		UInteractableComponent* Interactable = Check.Interactable.Get();
+
+		// Cluster members are discovered by their cluster
+		if (!Interactable || !Interactable->HasBegunPlay() || Interactable->GetCluster() || !Interactable->SphereComponent)
+		{
+			continue;
+		}
+
+		const FVector Location = Interactable->GetComponentLocation();
+		const float SphereRadius = Interactable->SphereComponent->GetScaledSphereRadius();
+
+		for (const FLocalPlayer& LocalPlayer : LocalPlayers)
+		{
+			const float Reach = SphereRadius + LocalPlayer.Radius;
+
+			if (FVector::DistSquared(LocalPlayer.Location, Location) <= Reach * Reach)
+			{
+				LocalPlayer.Player->AddInteractable(Interactable);
+			}
+		}
+	}
+
+	SET_DWORD_STAT(STAT_InteractionPendingOverlaps, PendingOverlapChecks.Num());
+}
+
+bool UInteractionSubsystem::IsDebugOverlayEnabled()
+{
+#if !UE_BUILD_SHIPPING
+	return CVarDebugOverlay.GetValueOnGameThread() != 0;
+#else
+	return false;
+#endif //!UE_BUILD_SHIPPING
+}
+
+void UInteractionSubsystem::DrawDebugOverlay(UCanvas* Canvas, APlayerController* PlayerController)
+{
+#if !UE_BUILD_SHIPPING
+	const int32 Mode = CVarDebugOverlay.GetValueOnGameThread();
+
+	// Draw delegates are shared by every viewport, PIE windows only draw the players of their own world
+	if (!Mode || !Canvas || !PlayerController || PlayerController->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	if (const UPlayerInteractionComponent* Player = FindPlayerInteractionComponent(PlayerController->GetPawn()))
+	{
+		Player->DrawDebugOverlay(Canvas, Mode == 2);
+	}
+#endif //!UE_BUILD_SHIPPING
+}
+
+bool UInteractionSubsystem::IsLatencyTelemetryEnabled()
+{
+	return CVarLatencyTelemetry.GetValueOnGameThread() != 0;
+}
+
+void UInteractionSubsystem::RecordLatency(EInteractionLatencyStage Stage, float Milliseconds)
+{
+	const int32 Index = static_cast<int32>(Stage);
+
+	if (Index < 0 || Index >= static_cast<int32>(EInteractionLatencyStage::MAX))
+	{
+		return;
+	}
+
+	FInteractionLatencyHistogram& Histogram = LatencyHistograms[Index];
+	Histogram.Add(Milliseconds);
+
+#if STATS
+	static const FName StatNames[][3] =
+	{
+		{ GET_STATFNAME(STAT_InteractionLatencyInputP50), GET_STATFNAME(STAT_InteractionLatencyInputP95),
+			GET_STATFNAME(STAT_InteractionLatencyInputP99) },
+		{ GET_STATFNAME(STAT_InteractionLatencyHoldP50), GET_STATFNAME(STAT_InteractionLatencyHoldP95),
+			GET_STATFNAME(STAT_InteractionLatencyHoldP99) },
+		{ GET_STATFNAME(STAT_InteractionLatencyQueueP50), GET_STATFNAME(STAT_InteractionLatencyQueueP95),
+			GET_STATFNAME(STAT_InteractionLatencyQueueP99) },
+		{ GET_STATFNAME(STAT_InteractionLatencyExecuteP50), GET_STATFNAME(STAT_InteractionLatencyExecuteP95),
+			GET_STATFNAME(STAT_InteractionLatencyExecuteP99) },
+		{ GET_STATFNAME(STAT_InteractionLatencyNetworkP50), GET_STATFNAME(STAT_InteractionLatencyNetworkP95),
+			GET_STATFNAME(STAT_InteractionLatencyNetworkP99) },
+		{ GET_STATFNAME(STAT_InteractionLatencyTotalP50), GET_STATFNAME(STAT_InteractionLatencyTotalP95),
+			GET_STATFNAME(STAT_InteractionLatencyTotalP99) }
+	};
+
+	SET_FLOAT_STAT_FName(StatNames[Index][0], Histogram.GetPercentile(0.5f));
+	SET_FLOAT_STAT_FName(StatNames[Index][1], Histogram.GetPercentile(0.95f));
+	SET_FLOAT_STAT_FName(StatNames[Index][2], Histogram.GetPercentile(0.99f));
+#endif //STATS
+
+#if CSV_PROFILER
+	static const FName CsvStatNames[] =
+	{
+		GetLatencyStageName(EInteractionLatencyStage::Input),
+		GetLatencyStageName(EInteractionLatencyStage::Hold),
+		GetLatencyStageName(EInteractionLatencyStage::Queue),
+		GetLatencyStageName(EInteractionLatencyStage::Execute),
+		GetLatencyStageName(EInteractionLatencyStage::Network),
+		GetLatencyStageName(EInteractionLatencyStage::Total)
+	};
+
+	FCsvProfiler::RecordCustomStat(CsvStatNames[Index], CSV_CATEGORY_INDEX(InteractionLatency), Milliseconds,
+		ECsvCustomStatOp::Set);
+#endif //CSV_PROFILER
+}
+
+const FInteractionLatencyHistogram& UInteractionSubsystem::GetLatencyHistogram(EInteractionLatencyStage Stage) const
+{
+	return LatencyHistograms[FMath::Clamp(static_cast<int32>(Stage), 0,
+		static_cast<int32>(EInteractionLatencyStage::MAX) - 1)];
+}
+
+float UInteractionSubsystem::GetLatencyPercentile(EInteractionLatencyStage Stage, float Fraction) const
+{
+	return GetLatencyHistogram(Stage).GetPercentile(Fraction);
+}
+
+void UInteractionSubsystem::ResetLatencyHistograms()
+{
+	for (FInteractionLatencyHistogram& Histogram : LatencyHistograms)
+	{
+		Histogram.Reset();
+	}
+}
+
+void UInteractionSubsystem::SetRandomSeed(int32 Seed)
+{
+	RandomSeed = Seed;
+	bUseRandomSeed = true;
+
+	for (TObjectIterator<UInteractableComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == GetWorld() && !It->IsTemplate() && It->HasBegunPlay())
+		{
+			It->RandomizeValues();
+		}
+	}
+}
+
+bool UInteractionSubsystem::GetRandomStream(const UObject* Object, FRandomStream& OutStream) const
+{
+	if (!bUseRandomSeed || !Object)
+	{
+		return false;
+	}
+
+	// PIE prefixes are removed so PIE and standalone sessions pick the same values
+	OutStream.Initialize(static_cast<int32>(HashCombine(static_cast<uint32>(RandomSeed),
+		GetTypeHash(UWorld::RemovePIEPrefix(Object->GetPathName())))));
+
+	return true;
+}
+
+void UInteractionSubsystem::GatherReplayPlayers()
+{
+	ReplayPlayers.Reset();
+
+	for (const TWeakObjectPtr<UPlayerInteractionComponent>& Player : RegisteredPlayers)
+	{
+		const APawn* Pawn = Player.IsValid() ? Cast<APawn>(Player->GetOwner()) : nullptr;
+
+		if (Pawn && Pawn->IsLocallyControlled() && Pawn->IsPlayerControlled())
+		{
+			ReplayPlayers.Add(Player);
+		}
+	}
+
+	ReplayPlayers.Sort([](const TWeakObjectPtr<UPlayerInteractionComponent>& LHS,
+		const TWeakObjectPtr<UPlayerInteractionComponent>& RHS)
+	{
+		return LHS->GetOwner()->GetFName().LexicalLess(RHS->GetOwner()->GetFName());
+	});
+
+	PendingReplayInputs.Reset();
+	PendingReplayInputs.SetNum(ReplayPlayers.Num());
+}
+
+void UInteractionSubsystem::BindReplayDelegates()
+{
+	if (!WorldTickStartHandle.IsValid())
+	{
+		WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this,
+			&UInteractionSubsystem::OnWorldTickStart);
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this,
+			&UInteractionSubsystem::OnWorldPostActorTick);
+	}
+}
+
+void UInteractionSubsystem::UnbindReplayDelegates()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	WorldTickStartHandle.Reset();
+	PostActorTickHandle.Reset();
+}
+
+void UInteractionSubsystem::SetReplayPlayersControlDisabled(bool bDisabled)
+{
+	for (const TWeakObjectPtr<UPlayerInteractionComponent>& Player : ReplayPlayers)
+	{
+		const APawn* Pawn = Player.IsValid() ? Cast<APawn>(Player->GetOwner()) : nullptr;
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		if (UPawnMovementComponent* Movement = Pawn->GetMovementComponent())
+		{
+			Movement->SetActive(!bDisabled);
+		}
+
+		APlayerController* PlayerController = Cast<APlayerController>(Pawn->GetController());
+
+		if (!PlayerController)
+		{
+			continue;
+		}
+
+		// Control rotations are replayed, look input would be applied on top of them
+		if (bDisabled)
+		{
+			PlayerController->DisableInput(PlayerController);
+			PlayerController->SetIgnoreLookInput(true);
+			PlayerController->SetIgnoreMoveInput(true);
+		}
+		else
+		{
+			PlayerController->EnableInput(PlayerController);
+			PlayerController->ResetIgnoreLookInput();
+			PlayerController->ResetIgnoreMoveInput();
+		}
+	}
+}
+
+void UInteractionSubsystem::StartRecording(const FString& Filename)
+{
+	if (bReplaying)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("StartRecording() called while a replay is running."));
+		return;
+	}
+
+	StopRecording();
+
+	// Without a configured seed every recording gets its own, replays reproduce it from the file
+	SetRandomSeed(bUseRandomSeed ? RandomSeed : FMath::Rand());
+
+	Recording = FInteractionReplay();
+	Recording.RandomSeed = RandomSeed;
+	Recording.MapName = UWorld::RemovePIEPrefix(GetWorld()->GetMapName());
+	RecordingFilename = Filename;
+	ReplayPlayers.Reset();
+	PendingReplayInputs.Reset();
+	bRecording = true;
+
+	BindReplayDelegates();
+
+	UE_LOG(InteractionSystem, Log, TEXT("Interaction recording started, seed %d."), RandomSeed);
+}
+
+void UInteractionSubsystem::StopRecording()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	bRecording = false;
+	UnbindReplayDelegates();
+
+	if (Recording.SaveToFile(RecordingFilename))
+	{
+		UE_LOG(InteractionSystem, Log, TEXT("Interaction recording of %d frames written to %s."),
+			Recording.Frames.Num(), *FInteractionReplay::GetReplayPath(RecordingFilename));
+	}
+	else
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interaction recording couldn't be written to %s."),
+			*FInteractionReplay::GetReplayPath(RecordingFilename));
+	}
+
+	Recording = FInteractionReplay();
+}
+
+bool UInteractionSubsystem::StartReplay(const FString& Filename)
+{
+	StopRecording();
+	StopReplay();
+
+	if (!Replay.LoadFromFile(Filename))
+	{
+		return false;
+	}
+
+	if (Replay.MapName != UWorld::RemovePIEPrefix(GetWorld()->GetMapName()))
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Interaction replay was recorded on %s, replaying it on %s."),
+			*Replay.MapName, *UWorld::RemovePIEPrefix(GetWorld()->GetMapName()));
+	}
+
+	SetRandomSeed(Replay.RandomSeed);
+
+	ReplayPlayers.Reset();
+	ReplayFrame = 0;
+	ReplaySelectionChecksum = 0;
+	bReplaying = true;
+
+	// Frame times are replayed through the fixed time step, each frame sets the delta time of the next one
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+
+	if (Replay.Frames.Num())
+	{
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(Replay.Frames[0].DeltaTime);
+	}
+
+	BindReplayDelegates();
+
+	UE_LOG(InteractionSystem, Log, TEXT("Interaction replay of %d frames started, seed %d."), Replay.Frames.Num(),
+		RandomSeed);
+
+	return true;
+}
+
+void UInteractionSubsystem::StopReplay()
+{
+	if (!bReplaying)
+	{
+		return;
+	}
+
+	bReplaying = false;
+	UnbindReplayDelegates();
+
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+
+	SetReplayPlayersControlDisabled(false);
+
+	UE_LOG(InteractionSystem, Log, TEXT("Interaction replay stopped after %d of %d frames, selection checksum %08X."),
+		ReplayFrame, Replay.Frames.Num(), ReplaySelectionChecksum);
+
+	ReplayPlayers.Reset();
+	Replay = FInteractionReplay();
+}
+
+void UInteractionSubsystem::RecordReplayInput(const UPlayerInteractionComponent* Player,
+	EInteractionReplayInput Input)
+{
+	if (!bRecording)
+	{
+		return;
+	}
+
+	// Inputs can be raised before the first frame is recorded
+	if (!ReplayPlayers.Num())
+	{
+		GatherReplayPlayers();
+	}
+
+	const int32 Index = ReplayPlayers.IndexOfByKey(Player);
+
+	if (PendingReplayInputs.IsValidIndex(Index))
+	{
+		PendingReplayInputs[Index].Add(Input);
+	}
+}
+
+void UInteractionSubsystem::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (InWorld != GetWorld() || !bReplaying || !Replay.Frames.IsValidIndex(ReplayFrame))
+	{
+		return;
+	}
+
+	const FInteractionReplayFrame& Frame = Replay.Frames[ReplayFrame];
+
+	// The replay waits until every recorded player spawned
+	if (ReplayPlayers.Num() < Frame.Players.Num())
+	{
+		GatherReplayPlayers();
+
+		if (ReplayPlayers.Num() < Frame.Players.Num())
+		{
+			return;
+		}
+
+		SetReplayPlayersControlDisabled(true);
+	}
+
+	for (int32 Index = 0; Index < Frame.Players.Num(); ++Index)
+	{
+		UPlayerInteractionComponent* Player = ReplayPlayers[Index].Get();
+		APawn* Pawn = Player ? Cast<APawn>(Player->GetOwner()) : nullptr;
+
+		if (!Pawn)
+		{
+			continue;
+		}
+
+		const FInteractionReplayPlayer& Recorded = Frame.Players[Index];
+
+		Pawn->SetActorLocationAndRotation(Recorded.Location, Recorded.Rotation, false, nullptr,
+			ETeleportType::TeleportPhysics);
+
+		if (AController* Controller = Pawn->GetController())
+		{
+			Controller->SetControlRotation(Recorded.ControlRotation);
+		}
+
+		for (const EInteractionReplayInput Input : Recorded.Inputs)
+		{
+			switch (Input)
+			{
+			case EInteractionReplayInput::Interact:
+				Player->InteractWithInteractables();
+				break;
+			case EInteractionReplayInput::InteractOnServer:
+				Player->InteractWithInteractablesOnServer();
+				break;
+			case EInteractionReplayInput::StopInteraction:
+				Player->StopInteraction();
+				break;
+			}
+		}
+	}
+
+	++ReplayFrame;
+
+	if (Replay.Frames.IsValidIndex(ReplayFrame))
+	{
+		FApp::SetFixedDeltaTime(Replay.Frames[ReplayFrame].DeltaTime);
+	}
+}
+
+void UInteractionSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime)
+{
+	if (InWorld != GetWorld())
+	{
+		return;
+	}
+
+	if (bReplaying)
+	{
+		if (!ReplayFrame)
+		{
+			return;
+		}
+
+		for (const TWeakObjectPtr<UPlayerInteractionComponent>& Player : ReplayPlayers)
+		{
+			const UInteractableComponent* Selected = Player.IsValid() ? Player->InteractableInteracted.Get() : nullptr;
+
+			ReplaySelectionChecksum = HashCombine(ReplaySelectionChecksum,
+				GetTypeHash(Selected ? UWorld::RemovePIEPrefix(Selected->GetPathName()) : FString()));
+		}
+
+		if (ReplayFrame >= Replay.Frames.Num())
+		{
+			StopReplay();
+
+			if (FParse::Param(FCommandLine::Get(), TEXT("InteractionReplayExit")))
+			{
+				FPlatformMisc::RequestExit(false);
+			}
+		}
+
+		return;
+	}
+
+	if (!bRecording)
+	{
+		return;
+	}
+
+	if (!ReplayPlayers.Num())
+	{
+		GatherReplayPlayers();
+
+		if (!ReplayPlayers.Num())
+		{
+			return;
+		}
+	}
+
+	FInteractionReplayFrame& Frame = Recording.Frames.AddDefaulted_GetRef();
+	// Undilated like the fixed time step it is replayed with
+	Frame.DeltaTime = FApp::GetDeltaTime();
+	Frame.Players.SetNum(ReplayPlayers.Num());
+
+	for (int32 Index = 0; Index < ReplayPlayers.Num(); ++Index)
+	{
+		FInteractionReplayPlayer& Recorded = Frame.Players[Index];
+		Recorded.Inputs = MoveTemp(PendingReplayInputs[Index]);
+		PendingReplayInputs[Index].Reset();
+
+		if (const APawn* Pawn = ReplayPlayers[Index].IsValid() ? Cast<APawn>(ReplayPlayers[Index]->GetOwner())
+			: nullptr)
+		{
+			Recorded.Location = Pawn->GetActorLocation();
+			Recorded.Rotation = Pawn->GetActorRotation();
+			Recorded.ControlRotation = Pawn->GetControlRotation();
+		}
+	}
+}
+
+bool UInteractionSubsystem::IsParallelEvaluationEnabled()
+{
+	return CVarParallelEvaluation.GetValueOnGameThread() != 0;
+}
+
+bool UInteractionSubsystem::IsEventDeferralEnabled()
+{
+	return CVarDeferredEvents.GetValueOnGameThread() != 0;
+}
+
+void UInteractionSubsystem::BroadcastEvent(EInteractionEvent Event, UInteractableComponent* Interactable,
+	UPlayerInteractionComponent* Player)
+{
+	FInteractionEvent NewEvent;
+	NewEvent.Interactable = Interactable;
+	NewEvent.Player = Player;
+	NewEvent.Type = Event;
+
+	UInteractionSubsystem* Subsystem = Interactable ? Get(Interactable) : Get(Player);
+
+	if (!Subsystem || !Subsystem->IsTickable() || !IsEventDeferralEnabled())
+	{
+		FInteractionEventQueue::Dispatch(NewEvent);
+		return;
+	}
+
+	// The subsystem doesn't tick while paused, events queued before the pause go first to keep the order
+	if (Subsystem->GetWorld()->IsPaused())
+	{
+		Subsystem->FlushEvents();
+		FInteractionEventQueue::Dispatch(NewEvent);
+		return;
+	}
+
+	Subsystem->EventQueue.Add(Event, Interactable, Player);
+}
+
+void UInteractionSubsystem::FlushEvents()
+{
+	if (!EventQueue.Num())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_InteractionFlushEvents);
+	TRACE_INTERACTION_SCOPE(Interaction_FlushEvents);
+
+	EventQueue.Flush();
+}
+
+void FInteractionEvaluationTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType,
+	ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->EvaluateUsedSelections();
+	}
+}
+
+FString FInteractionEvaluationTickFunction::DiagnosticMessage()
+{
+	return TEXT("FInteractionEvaluationTickFunction");
+}
+
+void UInteractionSubsystem::AddEvaluationPrerequisite(FTickFunction& ComponentTick)
+{
+	UWorld* World = GetWorld();
+
+	if (!World || !World->IsGameWorld() || !World->PersistentLevel)
+	{
+		return;
+	}
+
+	if (!EvaluationTickFunction.IsTickFunctionRegistered())
+	{
+		EvaluationTickFunction.Subsystem = this;
+		EvaluationTickFunction.TickGroup = TG_PostPhysics;
+		EvaluationTickFunction.bCanEverTick = true;
+		EvaluationTickFunction.bStartWithTickEnabled = true;
+		EvaluationTickFunction.bHighPriority = true;
+		EvaluationTickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+
+	ComponentTick.AddPrerequisite(this, EvaluationTickFunction);
+}
+
+void UInteractionSubsystem::RemoveEvaluationPrerequisite(FTickFunction& ComponentTick)
+{
+	ComponentTick.RemovePrerequisite(this, EvaluationTickFunction);
+}
+
+void UInteractionSubsystem::EvaluateUsedSelections()
+{
+	if (!IsTickable() || !IsParallelEvaluationEnabled())
+	{
+		return;
+	}
+
+	INTERACTION_BENCHMARK_SCOPE();
+
+	// Players nothing asked for a selection last frame keep evaluating on demand
+	TArray<UPlayerInteractionComponent*, TInlineAllocator<8>> Players;
+
+	for (const TWeakObjectPtr<UPlayerInteractionComponent>& Player : RegisteredPlayers)
+	{
+		if (Player.IsValid() && Player->ActorsToInteract.Num() && Player->SelectionFrame + 1 == GFrameCounter)
+		{
+			Players.Add(Player.Get());
+		}
+	}
+
+	if (Players.Num())
+	{
+		EvaluateSelections(Players);
+	}
+}
+
+void UInteractionSubsystem::EvaluateSelections(TArrayView<UPlayerInteractionComponent* const> Players)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+	SCOPE_CYCLE_COUNTER(STAT_InteractionEvaluateSelections);
+	TRACE_INTERACTION_SCOPE(Interaction_EvaluateSelections);
+
+	EvaluationViews.Reset();
+	EvaluationJobs.Reset();
+	EvaluationBatch.Reset();
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_InteractionEvaluateGather);
+
+		for (UPlayerInteractionComponent* Player : Players)
+		{
+			if (!Player)
+			{
+				continue;
+			}
+
+			FEvaluationBatchEntry& Entry = EvaluationBatch.AddDefaulted_GetRef();
+			const int32 NumViews = EvaluationViews.Num();
+
+			Entry.Player = Player;
+			Entry.FirstJob = EvaluationJobs.Num();
+
+			Player->GatherSelection(EvaluationViews, EvaluationJobs);
+
+			Entry.ViewIndex = EvaluationViews.Num() > NumViews ? NumViews : INDEX_NONE;
+			Entry.NumJobs = EvaluationJobs.Num() - Entry.FirstJob;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_InteractionEvaluatedCandidates, EvaluationJobs.Num());
+
+	// Jobs only read their own inputs, their view and the collision scene, nothing is written outside the job
+	{
+		SCOPE_CYCLE_COUNTER(STAT_InteractionEvaluateJobs);
+
+		const UWorld* World = GetWorld();
+		const bool bSingleThreaded = !IsParallelEvaluationEnabled() || !FApp::ShouldUseThreadingForPerformance()
+			|| EvaluationJobs.Num() < CVarParallelEvaluationMinJobs.GetValueOnGameThread();
+
+		ParallelFor(EvaluationJobs.Num(), [this, World](int32 Index)
+		{
+			FInteractionEvaluationJob& Job = EvaluationJobs[Index];
+
+			if (Job.Interactable)
+			{
+				Job.Evaluate(World, EvaluationViews[Job.ViewIndex]);
+			}
+		}, bSingleThreaded);
+	}
+
+	TArray<UPlayerInteractionComponent*, TInlineAllocator<8>> ChangedPlayers;
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_InteractionEvaluateApply);
+
+		for (const FEvaluationBatchEntry& Entry : EvaluationBatch)
+		{
+			const FInteractionEvaluationView* View = Entry.ViewIndex != INDEX_NONE ? &EvaluationViews[Entry.ViewIndex]
+				: nullptr;
+
+			if (Entry.Player->ApplySelection(MakeArrayView(EvaluationJobs.GetData() + Entry.FirstJob, Entry.NumJobs),
+				View))
+			{
+				ChangedPlayers.Add(Entry.Player);
+			}
+		}
+	}
+
+	// Broadcasted last, a handler may start another pass which reuses the scratch arrays
+	for (UPlayerInteractionComponent* Player : ChangedPlayers)
+	{
+		Player->BroadcastSelection();
+	}
+}
+
+void UInteractionSubsystem::GatherMemoryReport(FInteractionMemoryReport& Report) const
+{
+	const UWorld* World = GetWorld();
+
+	if (!World)
+	{
+		return;
+	}
+
+	AddMemoryUsage(Report);
+
+	int32 NumInteractables = 0;
+
+	for (TObjectIterator<UInteractableComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && !It->IsTemplate())
+		{
+			It->AddMemoryUsage(Report);
+			++NumInteractables;
+		}
+	}
+
+	for (TObjectIterator<UPlayerInteractionComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && !It->IsTemplate())
+		{
+			It->AddMemoryUsage(Report);
+		}
+	}
+
+	for (TObjectIterator<UInteractableClusterComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && !It->IsTemplate())
+		{
+			It->AddMemoryUsage(Report);
+		}
+	}
+
+	for (TObjectIterator<UInstancedInteractableComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == World && !It->IsTemplate())
+		{
+			It->AddMemoryUsage(Report);
+		}
+	}
+
+	/*Replication keeps a shadow copy of every replicated property per connection the actor is relevant to,
+	interactables only replicate their definition, bDisabled and Priority.*/
+	const UNetDriver* NetDriver = World->GetNetDriver();
+	const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+
+	Report.ReplicatedState.Add(NumInteractables * NumConnections, static_cast<SIZE_T>(NumInteractables) * NumConnections
+		* (sizeof(UInteractableDefinition*) + sizeof(int32) + sizeof(bool)));
+}
+
+void UInteractionSubsystem::AddMemoryUsage(FInteractionMemoryReport& Report) const
+{
+	Report.AddObject(Report.Components, this);
+
+	SIZE_T Bytes = PendingRequests.GetAllocatedSize() + ProcessingRequests.GetAllocatedSize()
+		+ ClaimedInteractables.GetAllocatedSize() + SpatialGrid.GetAllocatedSize() + DynamicGrid.GetAllocatedSize()
+		+ MovedInteractables.GetAllocatedSize() + TrackedPlayers.GetAllocatedSize()
+		+ ActorComponents.GetAllocatedSize() + LightweightStore.GetAllocatedSize()
+		+ LightweightGrid.GetAllocatedSize() + LightweightDefinitions.GetAllocatedSize()
+		+ ClaimedLightweight.GetAllocatedSize() + RegisteredPlayers.GetAllocatedSize()
+		+ StreamedInInteractables.GetAllocatedSize() + StreamedOutInteractables.GetAllocatedSize()
+		+ PendingOverlapChecks.GetAllocatedSize() + EvaluationViews.GetAllocatedSize()
+		+ EvaluationJobs.GetAllocatedSize() + EvaluationBatch.GetAllocatedSize() + EventQueue.GetAllocatedSize();
+
+	Report.Caches.Add(1, Bytes);
+}
+
+FInteractionHandle UInteractionSubsystem::AddLightweightInteractable(UInteractableDefinition* Definition,
+	FVector Location)
+{
+	return AddInstancedLightweightInteractable(Definition, Location, nullptr, INDEX_NONE);
+}
+
+FInteractionHandle UInteractionSubsystem::AddInstancedLightweightInteractable(UInteractableDefinition* Definition,
+	const FVector& Location, UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex)
+{
+	INTERACTION_LLM_SCOPE(Caches);
+
+	if (!Definition)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Definition passed to AddLightweightInteractable() is nullptr."));
+		return FInteractionHandle();
+	}
+
+	int32 DefinitionIndex = LightweightDefinitions.Find(Definition);
+
+	if (DefinitionIndex == INDEX_NONE)
+	{
+		DefinitionIndex = LightweightDefinitions.Add(Definition);
+	}
+
+	const FInteractionHandle Handle = LightweightStore.Add(Location, DefinitionIndex, InstanceComponent, InstanceIndex);
+
+	if (Definition->Settings.bDisabled)
+	{
+		LightweightStore.SetFlags(Handle, EInteractionLightweightFlags::Disabled);
+	}
+
+	LightweightStore.SetGridIndex(Handle,
+		LightweightGrid.Add(Location, Definition->Settings.MaximumDistanceToPlayer, Handle));
+
+	return Handle;
+}
+
+void UInteractionSubsystem::RemoveLightweightInteractable(FInteractionHandle Handle)
+{
+	if (!LightweightStore.IsValid(Handle))
+	{
+		return;
+	}
+
+	LightweightGrid.Remove(LightweightStore.GetGridIndex(Handle));
+	LightweightStore.Remove(Handle);
+}
+
+void UInteractionSubsystem::SetLightweightInteractableEnabled(FInteractionHandle Handle, bool bEnabled)
+{
+	if (!LightweightStore.IsValid(Handle))
+	{
+		return;
+	}
+
+	const uint8 Flags = LightweightStore.GetFlags(Handle);
+
+	LightweightStore.SetFlags(Handle, bEnabled ? Flags & ~EInteractionLightweightFlags::Disabled
+		: Flags | EInteractionLightweightFlags::Disabled);
+}
+
+bool UInteractionSubsystem::IsLightweightInteractableUsable(FInteractionHandle Handle) const
+{
+	return LightweightStore.IsValid(Handle) && !(LightweightStore.GetFlags(Handle)
+		& (EInteractionLightweightFlags::Disabled | EInteractionLightweightFlags::Used));
+}
+
+FVector UInteractionSubsystem::GetLightweightLocation(FInteractionHandle Handle) const
+{
+	return LightweightStore.IsValid(Handle) ? LightweightStore.GetLocation(Handle) : FVector::ZeroVector;
+}
+
+const FInteractable* UInteractionSubsystem::GetLightweightSettings(const FInteractionHandle& Handle) const
+{
+	if (!LightweightStore.IsValid(Handle))
+	{
+		return nullptr;
+	}
+
+	const UInteractableDefinition* Definition = LightweightDefinitions[LightweightStore.GetDefinitionIndex(Handle)];
+
+	return Definition ? &Definition->Settings : nullptr;
+}
+
+UInstancedStaticMeshComponent* UInteractionSubsystem::GetLightweightInstance(const FInteractionHandle& Handle,
+	int32& OutInstanceIndex) const
+{
+	if (!LightweightStore.IsValid(Handle))
+	{
+		OutInstanceIndex = INDEX_NONE;
+		return nullptr;
+	}
+
+	OutInstanceIndex = LightweightStore.GetInstanceIndex(Handle);
+
+	return LightweightStore.GetInstanceComponent(Handle);
+}
+
+FInteractionHandle UInteractionSubsystem::ResolveLightweightInstance(const FInteractionHandle& Handle,
+	const UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex) const
+{
+	if (!InstanceComponent)
+	{
+		return Handle;
+	}
+
+	const AActor* Owner = InstanceComponent->GetOwner();
+
+	if (!Owner)
+	{
+		return FInteractionHandle();
+	}
+
+	TInlineComponentArray<UInstancedInteractableComponent*> InstancedComponents(Owner);
+
+	for (const UInstancedInteractableComponent* InstancedComponent : InstancedComponents)
+	{
+		if (InstancedComponent->InstancedMesh == InstanceComponent)
+		{
+			return InstancedComponent->GetInstanceHandle(InstanceIndex);
+		}
+	}
+
+	return FInteractionHandle();
+}
+
+void UInteractionSubsystem::SetLightweightInstanceIndex(const FInteractionHandle& Handle, int32 InstanceIndex)
+{
+	if (LightweightStore.IsValid(Handle))
+	{
+		LightweightStore.SetInstanceIndex(Handle, InstanceIndex);
+	}
+}
+
+void UInteractionSubsystem::ExecuteLightweightInteraction(UPlayerInteractionComponent* Player,
+	const FInteractionHandle& Handle)
+{
+	const FInteractable* Settings = GetLightweightSettings(Handle);
+
+	if (!Player || !Settings)
+	{
+		return;
+	}
+
+	if (Settings->bDisableAfterUsage)
+	{
+		// Read before marking it used, a removed instance shifts the indices of the following ones
+		int32 InstanceIndex = INDEX_NONE;
+		UInstancedStaticMeshComponent* InstanceComponent = GetLightweightInstance(Handle, InstanceIndex);
+
+		MarkLightweightUsed(Handle);
+
+		// Players are only tracked on the server, every remote client hides the item as well
+		for (const auto& TrackedPlayer : TrackedPlayers)
+		{
+			if (TrackedPlayer.IsValid() && TrackedPlayer->PWN.IsValid() && !TrackedPlayer->PWN->IsLocallyControlled())
+			{
+				++TrackedPlayer->ClientRPCCount;
+				TrackedPlayer->LightweightUsedOn_Client(Handle, InstanceComponent, InstanceIndex);
+			}
+		}
+	}
+
+	OnLightweightInteracted.Broadcast(Handle, Player);
+
+	if (OnLightweightInteractedDelegate.IsBound())
+	{
+		OnLightweightInteractedDelegate.Broadcast(Handle, Player->GetOwner());
+	}
+}
+
+void UInteractionSubsystem::MarkLightweightUsed(const FInteractionHandle& Handle)
+{
+	if (!LightweightStore.IsValid(Handle))
+	{
+		return;
+	}
+
+	const uint8 Flags = LightweightStore.GetFlags(Handle);
+
+	if (Flags & EInteractionLightweightFlags::Hidden)
+	{
+		return;
+	}
+
+	LightweightStore.SetFlags(Handle, Flags | EInteractionLightweightFlags::Used | EInteractionLightweightFlags::Hidden);
+
+	// Instances are scaled to zero instead of removed so the instance indices of other items stay valid
+	UInstancedStaticMeshComponent* InstanceComponent = LightweightStore.GetInstanceComponent(Handle);
+	const int32 InstanceIndex = LightweightStore.GetInstanceIndex(Handle);
+	FTransform InstanceTransform;
+
+	if (InstanceComponent && InstanceComponent->GetInstanceTransform(InstanceIndex, InstanceTransform, true))
+	{
+		InstanceTransform.SetScale3D(FVector::ZeroVector);
+		InstanceComponent->UpdateInstanceTransform(InstanceIndex, InstanceTransform, true, true);
+	}
+
+	OnLightweightUsed.Broadcast(Handle);
+}
+
+void UInteractionSubsystem::UpdateServerCandidates()
+{
+	INTERACTION_LLM_SCOPE(Caches);
+	SCOPE_CYCLE_COUNTER(STAT_InteractionUpdateServerCandidates);
+	TRACE_INTERACTION_SCOPE(Interaction_UpdateServerCandidates);
+
+	if (!IsServerCandidateTrackingEnabled() || GetWorld()->GetNetMode() == NM_Client)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (auto It = TrackedPlayers.CreateIterator(); It; ++It)
+	{
+		UPlayerInteractionComponent* Player = It->Get();
+
+		if (!Player)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		const AActor* Owner = Player->GetOwner();
+
+		if (!Owner)
+		{
+			continue;
+		}
+
+		Player->ServerCandidatesUpdateTime = Now;
+
+		const auto AddCandidate = [Player, Now](int32 ElementIndex, const FInteractionGridEntry& Entry)
+		{
+			if (const UInteractableComponent* Component = Entry.Component.Get())
+			{
+				Player->ServerCandidates.FindOrAdd(Component) = Now;
+			}
+		};
+
+		const FVector PlayerLocation = Owner->GetActorLocation();
+		const float PlayerRadius = Owner->GetSimpleCollisionRadius();
+
+		SpatialGrid.Query(PlayerLocation, PlayerRadius, AddCandidate);
+
+		if (DynamicGrid.Num())
+		{
+			DynamicGrid.Query(PlayerLocation, PlayerRadius, AddCandidate);
+		}
+
+		// Candidates stay for the rewind window so lag compensated requests can still find them
+		const float Expiry = Now - Player->MaximumRewindTime;
+
+		for (auto CandidateIt = Player->ServerCandidates.CreateIterator(); CandidateIt; ++CandidateIt)
+		{
+			if (CandidateIt.Value() < Expiry || !CandidateIt.Key().ResolveObjectPtr())
+			{
+				CandidateIt.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void UInteractionSubsystem::Tick(float DeltaTime)
+{
+	INTERACTION_BENCHMARK_SCOPE();
+
+	// Levels loaded before the world began play and removals without a level removed broadcast
+	FlushStreamedOutInteractables();
+	FlushStreamedInInteractables();
+	ResolveInitialOverlaps();
+	FlushMovedInteractables();
+	UpdateServerCandidates();
+	ProcessInteractionRequests();
+	FlushEvents();
+}
+
+bool UInteractionSubsystem::IsTickable() const
+{
+	return bInitialized && !IsTemplate() && GetWorld() && GetWorld()->IsGameWorld();
+}
+
+TStatId UInteractionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionSubsystem, STATGROUP_InteractionSystem);
+}
@@ -0,0 +1,25 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#include "InteractionTrace.h"
+
+#if INTERACTION_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(InteractionChannel);
+
+UE_TRACE_EVENT_BEGIN(Interaction, Activity)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, InteractableId)
+	UE_TRACE_EVENT_FIELD(uint32, PlayerId)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+UE_TRACE_EVENT_END()
+
+void FInteractionTrace::OutputEvent(EInteractionTraceEvent Type, const UObject* Interactable, const UObject* Player)
+{
+	UE_TRACE_LOG(Interaction, Activity, InteractionChannel)
+		<< Activity.Cycle(FPlatformTime::Cycles64())
+		<< Activity.InteractableId(Interactable ? Interactable->GetUniqueID() : 0)
+		<< Activity.PlayerId(Player ? Player->GetUniqueID() : 0)
+		<< Activity.Type(static_cast<uint8>(Type));
+}
+
+#endif //INTERACTION_TRACE_ENABLED
@@ -7,23 +7,64 @@
 #include "InteractionHoldWidget.h"
 #include "InteractionWidgetOnInteractable.h"
 #include "InteractableWidget.h"
+#include "InteractionSubsystem.h"
+#include "InteractionStats.h"
+#include "InteractionTrace.h"
+#include "InteractionMemory.h"
 
 #include "Blueprint/UserWidget.h"
 
+#include "GameFramework/GameStateBase.h"
+#include "TimerManager.h"
+
 #include "Components/WidgetComponent.h"
 #include "Components/ArrowComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "SceneView.h"
+
+#include "Algo/BinarySearch.h"
 
 #include "InteractionLog.h"
 
+DECLARE_CYCLE_STAT(TEXT("ShowInteractableName"), STAT_InteractionShowName, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("ShowInteractionWidgetOnInteractable"), STAT_InteractionShowWidgetOnInteractable, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("ShowInteractionProgress"), STAT_InteractionShowProgress, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("ShowInteractionMarker"), STAT_InteractionShowMarker, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("ShowInteractionWidget"), STAT_InteractionShowWidget, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("HideInteractionWidget"), STAT_InteractionHideWidget, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("HideInteractionProgressWidget"), STAT_InteractionHideProgress, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("TryHideInteractableName"), STAT_InteractionTryHideName, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("TryHideInteractionWidgetOnInteractable"), STAT_InteractionTryHideWidgetOnInteractable, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("TryHideInteractionProgress"), STAT_InteractionTryHideProgress, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("TryHideInteractionMarker"), STAT_InteractionTryHideMarker, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("TryHideInteractionWidget"), STAT_InteractionTryHideWidget, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("AddActorToInteract"), STAT_InteractionAddActorToInteract, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("RemoveActorToInteract"), STAT_InteractionRemoveActorToInteract, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("Player Interaction Tick"), STAT_InteractionPlayerTick, STATGROUP_InteractionSystem);
+DECLARE_CYCLE_STAT(TEXT("DrawDebugOverlay"), STAT_InteractionDrawDebugOverlay, STATGROUP_InteractionSystem);
+
 UPlayerInteractionComponent::UPlayerInteractionComponent()
-	: CurrentTimeInSecondsForButtonHold(0.f), IsInteracting(false), IsOnlineInteracting(false)
+	: HoldStartTime(0.f), IsInteracting(false), IsOnlineInteracting(false), IsHoldingOnServer(false),
+	IsHoldTimedForClient(false)
 {
+	INTERACTION_LLM_SCOPE(Components);
+
 	PlayerInteractableForwardVector = CreateDefaultSubobject<UArrowComponent>(FName("InteractableForwardVector"));
 
 	SetIsReplicatedByDefault(true);
 
 	PrimaryComponentTick.bCanEverTick = true;
 
+	// Ticks after the selection batch of UInteractionSubsystem, which runs once movement is done
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+
 	if (GetOwner())
 	{
 		PlayerInteractableForwardVector->AttachToComponent(GetOwner()->GetRootComponent(),
@@ -33,6 +74,8 @@ UPlayerInteractionComponent::UPlayerInteractionComponent()
 
 void UPlayerInteractionComponent::HideInteractionWidget()
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionHideWidget);
+
 	if (InteractionWidgetBase.IsValid() && InteractionWidgetBase.Get()->IsVisible())
 	{
 		InteractionWidgetBase->SetVisibility(ESlateVisibility::Hidden);
@@ -41,16 +84,19 @@ void UPlayerInteractionComponent::HideInteractionWidget()
 
 void UPlayerInteractionComponent::HideInteractionProgressWidget()
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionHideProgress);
+
 	if (InteractionProgressWidget.IsValid())
 	{
 		InteractionProgressWidget->SetVisibility(ESlateVisibility::Hidden);
-		CurrentTimeInSecondsForButtonHold = 0.f;
 		InteractionProgressWidget->Reset();
 	}
 }
 
 void UPlayerInteractionComponent::TryHideInteractableName(UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTryHideName);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -66,6 +112,8 @@ void UPlayerInteractionComponent::TryHideInteractableName(UInteractableComponent
 
 void UPlayerInteractionComponent::TryHideInteractionWidgetOnInteractable(UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTryHideWidgetOnInteractable);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -81,6 +129,8 @@ void UPlayerInteractionComponent::TryHideInteractionWidgetOnInteractable(UIntera
 
 void UPlayerInteractionComponent::TryHideInteractionProgress(UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTryHideProgress);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -96,6 +146,8 @@ void UPlayerInteractionComponent::TryHideInteractionProgress(UInteractableCompon
 
 void UPlayerInteractionComponent::TryHideInteractionMarker(UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTryHideMarker);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning, 
@@ -111,6 +163,8 @@ void UPlayerInteractionComponent::TryHideInteractionMarker(UInteractableComponen
 
 void UPlayerInteractionComponent::TryHideInteractionWidget(const UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionTryHideWidget);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -154,8 +208,7 @@ void UPlayerInteractionComponent::RemoveActorToInteract(const AActor* Actor)
 		return;
 	}
 
-	UInteractableComponent* Component = Actor->
-		FindComponentByClass<UInteractableComponent>();
+	UInteractableComponent* Component = UInteractionSubsystem::FindInteractableComponent(Actor);
 
 	if (!Component)
 	{
@@ -168,9 +221,23 @@ void UPlayerInteractionComponent::RemoveActorToInteract(const AActor* Actor)
 		return;
 	}
 
-	if (ActorsToInteract.Contains(Component))
+	RemoveInteractable(Component);
+}
+
+void UPlayerInteractionComponent::RemoveInteractable(UInteractableComponent* Component)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionRemoveActorToInteract);
+
+	if (!Component)
+	{
+		UE_LOG(InteractionSystem, Warning,
+			TEXT("Component passed to RemoveInteractable() is nullptr."));
+		return;
+	}
+
+	if (CandidateKeys.Contains(Component))
 	{
-		if (Component->AmountOfSubscribedPlayers)
+		if (Component->IsSubscribed(this))
 		{
 			Component->UnsubscribeFromComponent(GetOwner());
 			TryHideInteractionMarker(Component);
@@ -180,27 +247,21 @@ void UPlayerInteractionComponent::RemoveActorToInteract(const AActor* Actor)
 			if (InteractableInteracted.IsValid() &&
 				InteractableInteracted.Get() == Component)
 			{
-				InteractableInteracted.Reset();
+				SetInteractableInteracted(nullptr);
 			}
 
-			if (OnInteractableUnsubscribedDelegate.IsBound())
-			{
-				OnInteractableUnsubscribedDelegate.Broadcast(Component->GetOwner());
-			}
+			UInteractionSubsystem::BroadcastEvent(EInteractionEvent::InteractableUnsubscribed, Component, this);
 		}
 
-		ActorsToInteract.Remove(Component);
+		RemoveCandidate(Component);
 
-		StopInteraction();
+		StopInteractionInternal();
 
 		if (!ActorsToInteract.Num())
 		{
 			TryHideInteractionWidget(Component);
 
-			if(OnNoInteractablesLeftDelegate.IsBound())
-			{
-				OnNoInteractablesLeftDelegate.Broadcast();
-			}
+			UInteractionSubsystem::BroadcastEvent(EInteractionEvent::NoInteractablesLeft, nullptr, this);
 
 			SetComponentTickEnabled(false);
 		}
@@ -208,8 +269,92 @@ void UPlayerInteractionComponent::RemoveActorToInteract(const AActor* Actor)
 		if (CanShowSystemLog)
 		{
 			UE_LOG(InteractionSystem, Log, 
-				TEXT("Removed %s from ActorsToInteract for %s player. Amount of actors to interact equals: %d"), *GetNameSafe(Actor), *GetNameSafe(GetOwner()), ActorsToInteract.Num());
+				TEXT("Removed %s from ActorsToInteract for %s player. Amount of actors to interact equals: %d"), *GetNameSafe(Component->GetOwner()), *GetNameSafe(GetOwner()), ActorsToInteract.Num());
+		}
+	}
+}
+
+void UPlayerInteractionComponent::RemoveInteractables(const TSet<const UInteractableComponent*>& Components)
+{
+	for (const UInteractableComponent* Component : Components)
+	{
+		ServerCandidates.Remove(Component);
+	}
+
+	TArray<UInteractableComponent*, TInlineAllocator<16>> Removed;
+
+	// RemoveAll keeps the order of the remaining candidates so they stay sorted
+	const int32 NumRemoved = ActorsToInteract.RemoveAll([&Components, &Removed](const FInteractionCandidate& Candidate)
+	{
+		UInteractableComponent* Component = Candidate.Component.Get();
+
+		if (!Component)
+		{
+			return true;
+		}
+
+		if (!Components.Contains(Component))
+		{
+			return false;
+		}
+
+		Removed.Add(Component);
+		return true;
+	});
+
+	if (!NumRemoved)
+	{
+		return;
+	}
+
+	CandidateKeys.Reset();
+
+	for (const FInteractionCandidate& Candidate : ActorsToInteract)
+	{
+		CandidateKeys.Add(Candidate.Component.Get(), Candidate);
+	}
+
+	bSelectionDirty = true;
+
+	// Delegates are broadcasted after the candidates are consistent since handlers may add or remove more
+	for (UInteractableComponent* Component : Removed)
+	{
+		if (!Component->IsSubscribed(this))
+		{
+			continue;
+		}
+
+		Component->UnsubscribeFromComponent(GetOwner());
+		TryHideInteractionMarker(Component);
+		TryHideInteractionWidgetOnInteractable(Component);
+		TryHideInteractableName(Component);
+
+		UInteractionSubsystem::BroadcastEvent(EInteractionEvent::InteractableUnsubscribed, Component, this);
+	}
+
+	if (!InteractableInteracted.IsValid() || !CandidateKeys.Contains(InteractableInteracted.Get()))
+	{
+		SetInteractableInteracted(nullptr);
+	}
+
+	StopInteractionInternal();
+
+	if (!ActorsToInteract.Num())
+	{
+		if (InteractionWidgetBase.Get() && InteractionWidgetBase->IsVisible())
+		{
+			HideInteractionWidget();
 		}
+
+		UInteractionSubsystem::BroadcastEvent(EInteractionEvent::NoInteractablesLeft, nullptr, this);
+
+		SetComponentTickEnabled(false);
+	}
+
+	if (CanShowSystemLog)
+	{
+		UE_LOG(InteractionSystem, Log,
+			TEXT("Removed %d actors from ActorsToInteract for %s player. Amount of actors to interact equals: %d"), NumRemoved, *GetNameSafe(GetOwner()), ActorsToInteract.Num());
 	}
 }
 
@@ -222,73 +367,1222 @@ void UPlayerInteractionComponent::ChangeInteractionWidget(const TSubclassOf<UInt
 }
 
 bool UPlayerInteractionComponent::InteractWithInteractablesOn_Server_Validate(
-	UInteractableComponent* ActorToInteract)
+	UInteractableComponent* ActorToInteract, float ClientTimeStamp)
+{
+	return true;
+}
+
+void UPlayerInteractionComponent::InteractWithInteractablesOn_Server_Implementation(
+	UInteractableComponent* ActorToInteract, float ClientTimeStamp)
+{
+	++ServerRPCCount;
+
+	TRACE_INTERACTION_EVENT(ServerRPCReceived, ActorToInteract, this);
+
+	if (!ActorToInteract)
+	{
+		return;
+	}
+
+	// Validated and executed in the next batch of the interaction subsystem
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->EnqueueInteraction(this, ActorToInteract, ClientTimeStamp, FPlatformTime::Seconds());
+	}
+}
+
+void UPlayerInteractionComponent::RejectInteraction(UInteractableComponent* ActorToInteract,
+	EInteractionRejectReason Reason)
+{
+	if (CanShowSystemLog)
+	{
+		UE_LOG(InteractionSystem, Log,
+			TEXT("Rejected interaction of player %s with %s, reason: %s."), *GetNameSafe(GetOwner()),
+			ActorToInteract ? *GetNameSafe(ActorToInteract->GetOwner()) : TEXT("None"),
+			Reason == EInteractionRejectReason::AlreadyClaimed ? TEXT("already claimed") : TEXT("not usable"));
+	}
+
+	if (IsHoldTimedForClient && HeldInteractable.IsValid() && HeldInteractable.Get() == ActorToInteract)
+	{
+		ClearHoldTimer();
+		++ClientRPCCount;
+		HoldStoppedOn_Client();
+	}
+
+	++ClientRPCCount;
+	InteractionRejectedOn_Client(ActorToInteract, Reason);
+}
+
+void UPlayerInteractionComponent::InteractionRejectedOn_Client_Implementation(
+	UInteractableComponent* ActorToInteract, EInteractionRejectReason Reason)
+{
+	PendingLatencySamples.Remove(ActorToInteract);
+
+	if (OnInteractionRejectedDelegate.IsBound())
+	{
+		OnInteractionRejectedDelegate.Broadcast(ActorToInteract ? ActorToInteract->GetOwner() : nullptr);
+	}
+}
+
+void UPlayerInteractionComponent::BeginLatencySample()
+{
+	bInputLatencyRecorded = false;
+
+	if (!UInteractionSubsystem::IsLatencyTelemetryEnabled())
+	{
+		InteractionInputTime = 0.0;
+		return;
+	}
+
+	// Input events are pumped at the start of the frame, the bindings calling this run later in the frame
+	const double Now = FPlatformTime::Seconds();
+
+	InteractionInputTime = FApp::UseFixedTimeStep() ? Now : FMath::Min(FApp::GetCurrentTime(), Now);
+}
+
+void UPlayerInteractionComponent::RecordInputLatency()
+{
+	if (InteractionInputTime <= 0.0 || bInputLatencyRecorded)
+	{
+		return;
+	}
+
+	bInputLatencyRecorded = true;
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RecordLatency(EInteractionLatencyStage::Input,
+			static_cast<float>((FPlatformTime::Seconds() - InteractionInputTime) * 1000.0));
+	}
+}
+
+void UPlayerInteractionComponent::TrackSentRequest(UInteractableComponent* Component, float HoldSeconds)
+{
+	RecordInputLatency();
+
+	if (InteractionInputTime <= 0.0 || !Component)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Confirmations are unreliable and released holds are never confirmed, stale samples are dropped here
+	for (auto It = PendingLatencySamples.CreateIterator(); It; ++It)
+	{
+		if (It.Value().ExpiryTime < Now || !It.Key().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	FPendingLatencySample& Sample = PendingLatencySamples.Add(Component);
+	Sample.InputTime = InteractionInputTime;
+	Sample.SendTime = Now;
+	Sample.ExpiryTime = Now + HoldSeconds + 5.0;
+	Sample.HoldSeconds = HoldSeconds;
+}
+
+void UPlayerInteractionComponent::RecordLocalTotalLatency(float HoldSeconds)
+{
+	if (InteractionInputTime <= 0.0)
+	{
+		return;
+	}
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RecordLatency(EInteractionLatencyStage::Total,
+			static_cast<float>((FPlatformTime::Seconds() - InteractionInputTime - HoldSeconds) * 1000.0));
+	}
+
+	InteractionInputTime = 0.0;
+}
+
+void UPlayerInteractionComponent::ConfirmInteraction(UInteractableComponent* Interactable, double ReceiveTime)
+{
+	++ClientRPCCount;
+	InteractionConfirmedOn_Client(Interactable, static_cast<float>((FPlatformTime::Seconds() - ReceiveTime) * 1000.0));
+}
+
+void UPlayerInteractionComponent::InteractionConfirmedOn_Client_Implementation(UInteractableComponent* Interactable,
+	float ServerTimeMs)
+{
+	FPendingLatencySample Sample;
+
+	if (!PendingLatencySamples.RemoveAndCopyValue(Interactable, Sample))
+	{
+		return;
+	}
+
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	if (!Subsystem)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+
+	// Clocks of the client and the server are never compared, only durations measured on each side
+	Subsystem->RecordLatency(EInteractionLatencyStage::Network,
+		static_cast<float>((Now - Sample.SendTime) * 1000.0) - ServerTimeMs);
+	Subsystem->RecordLatency(EInteractionLatencyStage::Total,
+		static_cast<float>((Now - Sample.InputTime - Sample.HoldSeconds) * 1000.0));
+}
+
+bool UPlayerInteractionComponent::ValidateInteractionAtTime(UInteractableComponent* Component,
+	float ClientTimeStamp) const
+{
+	if (!Component)
+	{
+		return false;
+	}
+
+	if (PWN.IsValid() && PWN->IsLocallyControlled())
+	{
+		return true;
+	}
+
+	// Cheap reject before any trace, interactables never in range of this player can't be used
+	if (UInteractionSubsystem::IsServerCandidateTrackingEnabled() && !IsServerCandidate(Component))
+	{
+		return false;
+	}
+
+	if (!bUseLagCompensation)
+	{
+		return true;
+	}
+
+	const float ServerTime = GetServerWorldTime();
+	const float RewindTime = FMath::Clamp(ClientTimeStamp, ServerTime - MaximumRewindTime, ServerTime);
+
+	FInteractionPlayerSnapshot Snapshot;
+
+	if (!GetSnapshotAtTime(RewindTime, Snapshot))
+	{
+		Snapshot = MakeSnapshot();
+	}
+
+	return Component->CanInteractFromSnapshot(this, Snapshot);
+}
+
+bool UPlayerInteractionComponent::ValidateLightweightAtTime(const FInteractionHandle& Handle,
+	float ClientTimeStamp) const
+{
+	const UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+	const FInteractable* Settings = Subsystem ? Subsystem->GetLightweightSettings(Handle) : nullptr;
+
+	if (!Settings || !Subsystem->IsLightweightInteractableUsable(Handle) || !GetOwner())
+	{
+		return false;
+	}
+
+	if (PWN.IsValid() && PWN->IsLocallyControlled())
+	{
+		return true;
+	}
+
+	if (!Settings->bDoesDistanceToPlayerMatter)
+	{
+		return true;
+	}
+
+	FVector PlayerLocation = GetOwner()->GetActorLocation();
+
+	if (bUseLagCompensation)
+	{
+		const float ServerTime = GetServerWorldTime();
+		const float RewindTime = FMath::Clamp(ClientTimeStamp, ServerTime - MaximumRewindTime, ServerTime);
+
+		FInteractionPlayerSnapshot Snapshot;
+
+		if (GetSnapshotAtTime(RewindTime, Snapshot))
+		{
+			PlayerLocation = Snapshot.PawnLocation;
+		}
+	}
+
+	const float Reach = Settings->MaximumDistanceToPlayer + GetOwner()->GetSimpleCollisionRadius();
+
+	return FVector::DistSquared(PlayerLocation, Subsystem->GetLightweightLocation(Handle)) <= Reach * Reach;
+}
+
+float UPlayerInteractionComponent::GetServerWorldTime() const
+{
+	if (!GetWorld())
+	{
+		return 0.f;
+	}
+
+	if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		return GameState->GetServerWorldTimeSeconds();
+	}
+
+	return GetWorld()->GetTimeSeconds();
+}
+
+bool UPlayerInteractionComponent::GetSnapshotAtTime(float TimeStamp, FInteractionPlayerSnapshot& OutSnapshot) const
+{
+	return PositionHistory.Sample(TimeStamp, OutSnapshot);
+}
+
+bool UPlayerInteractionComponent::IsServerCandidate(const UInteractableComponent* Component) const
+{
+	return Component && ServerCandidates.Contains(Component);
+}
+
+TArray<UInteractableComponent*> UPlayerInteractionComponent::GetServerCandidates() const
 {
+	TArray<UInteractableComponent*> Candidates;
+
+	for (const auto& Candidate : ServerCandidates)
+	{
+		if (Candidate.Value >= ServerCandidatesUpdateTime)
+		{
+			if (UInteractableComponent* Component = Candidate.Key.ResolveObjectPtr())
+			{
+				Candidates.Add(Component);
+			}
+		}
+	}
+
+	return Candidates;
+}
+
+FInteractionPlayerSnapshot UPlayerInteractionComponent::MakeSnapshot() const
+{
+	FInteractionPlayerSnapshot Snapshot;
+	Snapshot.TimeStamp = GetServerWorldTime();
+
+	if (const APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		Snapshot.PawnLocation = Pawn->GetActorLocation();
+		Snapshot.ViewLocation = Pawn->GetPawnViewLocation();
+		Snapshot.ViewRotation = Pawn->GetBaseAimRotation();
+		Snapshot.ForwardVector = Pawn->GetActorForwardVector();
+
+		// The angle evaluation uses the first arrow found on the player
+		if (const UArrowComponent* Arrow = PlayerArrow.Get())
+		{
+			Snapshot.ForwardVector = Arrow->GetForwardVector().GetSafeNormal();
+		}
+	}
+
+	return Snapshot;
+}
+
+void UPlayerInteractionComponent::RecordHistorySample()
+{
+	PositionHistory.Record(MakeSnapshot());
+}
+
+void UPlayerInteractionComponent::InteractWithInteractablesOnServer()
+ {
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RecordReplayInput(this, EInteractionReplayInput::InteractOnServer);
+	}
+
+	StopInteractionInternal();
+	IsOnlineInteracting = true;
+	BeginLatencySample();
+
+	// Reliable like the request, so the server has the current view before validating its angle
+	UpdateClientView();
+
+	if (ActorsToInteract.Num() > 0)
+	{
+		// Same selection as the offline path, the hysteresis keeps a still usable InteractableInteracted
+		UpdateSelection(true);
+
+		UInteractableComponent* Selected = GetScoredCandidate();
+
+		if (!Selected)
+		{
+			return;
+		}
+
+		if (Selected->GetSettings().bHoldButtonToInteract)
+		{
+			StartHold(Selected);
+			return;
+		}
+
+		TRACE_INTERACTION_EVENT(ServerRPCSent, Selected, this);
+		TrackSentRequest(Selected, 0.f);
+		InteractWithInteractablesOn_Server(Selected, GetServerWorldTime());
+	}
+	else
+	{
+		TryInteractWithLightweight(true);
+	}
+}
+
+bool UPlayerInteractionComponent::IsCandidateBefore(const FInteractionCandidate& LHS,
+	const FInteractionCandidate& RHS) const
+{
+	if (LHS.Priority != RHS.Priority)
+	{
+		return bUseLowerPriorityFirst ? LHS.Priority < RHS.Priority : LHS.Priority > RHS.Priority;
+	}
+
+	if (LHS.DistanceSquared != RHS.DistanceSquared)
+	{
+		return LHS.DistanceSquared < RHS.DistanceSquared;
+	}
+
+	return LHS.InsertionOrder < RHS.InsertionOrder;
+}
+
+void UPlayerInteractionComponent::SortActors()
+{
+	// Only needed when bUseLowerPriorityFirst changed, candidates are otherwise kept in order on insertion
+	if (bCandidatesSortedByLowerPriority == bUseLowerPriorityFirst)
+	{
+		return;
+	}
+
+	bCandidatesSortedByLowerPriority = bUseLowerPriorityFirst;
+	bSelectionDirty = true;
+
+	ActorsToInteract.Sort([this](const FInteractionCandidate& LHS, const FInteractionCandidate& RHS)
+	{
+		return IsCandidateBefore(LHS, RHS);
+	});
+}
+
+void UPlayerInteractionComponent::InsertCandidate(UInteractableComponent* Component)
+{
+	SortActors();
+
+	FInteractionCandidate Candidate;
+	Candidate.Component = Component;
+	Candidate.Priority = Component->GetPriority();
+	Candidate.DistanceSquared = GetOwner() ? FVector::DistSquared(GetOwner()->GetActorLocation(),
+		Component->GetComponentLocation()) : 0.f;
+	Candidate.InsertionOrder = NextCandidateInsertionOrder++;
+
+	const int32 Index = Algo::LowerBound(ActorsToInteract, Candidate,
+		[this](const FInteractionCandidate& LHS, const FInteractionCandidate& RHS)
+		{
+			return IsCandidateBefore(LHS, RHS);
+		});
+
+	ActorsToInteract.Insert(Candidate, Index);
+	CandidateKeys.Add(Component, Candidate);
+
+	bSelectionDirty = true;
+}
+
+bool UPlayerInteractionComponent::RemoveCandidate(const UInteractableComponent* Component)
+{
+	FInteractionCandidate Candidate;
+
+	if (!CandidateKeys.RemoveAndCopyValue(Component, Candidate))
+	{
+		return false;
+	}
+
+	SortActors();
+
+	bSelectionDirty = true;
+
+	const int32 Index = Algo::LowerBound(ActorsToInteract, Candidate,
+		[this](const FInteractionCandidate& LHS, const FInteractionCandidate& RHS)
+		{
+			return IsCandidateBefore(LHS, RHS);
+		});
+
+	if (ActorsToInteract.IsValidIndex(Index) && ActorsToInteract[Index].InsertionOrder == Candidate.InsertionOrder)
+	{
+		ActorsToInteract.RemoveAt(Index, 1, false);
+	}
+	else
+	{
+		ActorsToInteract.RemoveAll([&Candidate](const FInteractionCandidate& Other)
+		{
+			return Other.InsertionOrder == Candidate.InsertionOrder;
+		});
+	}
+
+	return true;
+}
+
+void UPlayerInteractionComponent::OnInteractablePriorityChanged(UInteractableComponent* Component)
+{
+	if (!Component || !RemoveCandidate(Component))
+	{
+		return;
+	}
+
+	InsertCandidate(Component);
+}
+
+UInteractableComponent* UPlayerInteractionComponent::GetBestCandidate() const
+{
+	return ActorsToInteract.Num() ? ActorsToInteract[0].Component.Get() : nullptr;
+}
+
+void UPlayerInteractionComponent::UpdateSelection(bool bForce)
+{
+	if (!bForce && !bSelectionDirty && SelectionFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		UPlayerInteractionComponent* Player = this;
+
+		Subsystem->EvaluateSelections(MakeArrayView(&Player, 1));
+	}
+}
+
+void UPlayerInteractionComponent::GatherSelection(TArray<FInteractionEvaluationView>& Views,
+	TArray<FInteractionEvaluationJob>& Jobs)
+{
+	INTERACTION_LLM_SCOPE(Subscriptions);
+
+	SelectionFrame = GFrameCounter;
+	bSelectionDirty = false;
+	ScoredCandidate.Reset();
+
+	const int32 Num = ActorsToInteract.Num();
+	SelectionData.SetNum(Num);
+
+	// Counted where the candidates are evaluated, the player tick only runs during holds
+	INC_DWORD_STAT_BY(STAT_InteractionCandidates, Num);
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (FInteractionCandidate* Candidate = CandidateKeys.Find(ActorsToInteract[Index].Component.Get()))
+		{
+			Candidate->SelectionIndex = Index;
+		}
+	}
+
+	if (!Num || !GetOwner())
+	{
+		return;
+	}
+
+	const int32 ViewIndex = Views.Num();
+	GatherEvaluationView(Views.AddDefaulted_GetRef(), true);
+
+	// Disabled candidates are never reachable, the marker of every other candidate needs its reachability
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		FInteractionEvaluationJob& Job = Jobs.AddDefaulted_GetRef();
+
+		if (const UInteractableComponent* Component = ActorsToInteract[Index].Component.Get())
+		{
+			Component->GatherEvaluation(Views[ViewIndex], ViewIndex, !Component->bDisabled, Job);
+		}
+	}
+}
+
+bool UPlayerInteractionComponent::ApplySelection(TArrayView<const FInteractionEvaluationJob> Jobs,
+	const FInteractionEvaluationView* View)
+{
+	const int32 Num = ActorsToInteract.Num();
+
+	if (!Num || !View || Jobs.Num() != Num)
+	{
+		return false;
+	}
+
+	float MinPriority = MAX_flt;
+	float MaxPriority = -MAX_flt;
+	float MinRarity = MAX_flt;
+	float MaxRarity = -MAX_flt;
+	float MaxDistance = 0.f;
+	bool bAnyUsable = false;
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		const FInteractionEvaluationJob& Job = Jobs[Index];
+		UInteractableComponent* Component = ActorsToInteract[Index].Component.Get();
+
+		if (Component)
+		{
+			Component->ApplyEvaluation(Job, *View);
+		}
+
+		const bool bUsable = Component && Job.Evaluation.Result == EInteractionEvaluationResult::Usable;
+
+		SelectionData.Usable[Index] = bUsable;
+		SelectionData.Reachable[Index] = Job.bReachable;
+
+		if (!bUsable)
+		{
+			SelectionData.Priorities[Index] = 0.f;
+			SelectionData.Distances[Index] = 0.f;
+			SelectionData.ViewDots[Index] = 0.f;
+			SelectionData.Rarities[Index] = 0.f;
+			continue;
+		}
+
+		const float Priority = static_cast<float>(Component->GetPriority());
+		const float Rarity = static_cast<float>(Component->RarityValue);
+
+		SelectionData.Priorities[Index] = Priority;
+		SelectionData.Distances[Index] = Job.SelectionDistance;
+		SelectionData.ViewDots[Index] = Job.SelectionViewDot;
+		SelectionData.Rarities[Index] = Rarity;
+
+		MinPriority = FMath::Min(MinPriority, Priority);
+		MaxPriority = FMath::Max(MaxPriority, Priority);
+		MinRarity = FMath::Min(MinRarity, Rarity);
+		MaxRarity = FMath::Max(MaxRarity, Rarity);
+		MaxDistance = FMath::Max(MaxDistance, Job.SelectionDistance);
+		bAnyUsable = true;
+	}
+
+	if (!bAnyUsable)
+	{
+		return false;
+	}
+
+	// Score, branch free loop over the gathered arrays so it can be vectorized
+	const float PriorityRange = MaxPriority - MinPriority;
+	const float RarityRange = MaxRarity - MinRarity;
+	const float PriorityScale = PriorityRange > KINDA_SMALL_NUMBER ? SelectionWeights.Priority / PriorityRange : 0.f;
+	const float PriorityBase = bUseLowerPriorityFirst ? MaxPriority : MinPriority;
+	const float PrioritySign = bUseLowerPriorityFirst ? -1.f : 1.f;
+	const float RarityScale = RarityRange > KINDA_SMALL_NUMBER ? SelectionWeights.Rarity / RarityRange : 0.f;
+	const float DistanceScale = MaxDistance > KINDA_SMALL_NUMBER ? SelectionWeights.Distance / MaxDistance : 0.f;
+	const float AngleScale = SelectionWeights.ViewAngle * 0.5f;
+
+	const float* RESTRICT Priorities = SelectionData.Priorities.GetData();
+	const float* RESTRICT Distances = SelectionData.Distances.GetData();
+	const float* RESTRICT ViewDots = SelectionData.ViewDots.GetData();
+	const float* RESTRICT Rarities = SelectionData.Rarities.GetData();
+	float* RESTRICT Scores = SelectionData.Scores.GetData();
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		Scores[Index] = PrioritySign * (Priorities[Index] - PriorityBase) * PriorityScale
+			+ SelectionWeights.Distance - Distances[Index] * DistanceScale
+			+ (ViewDots[Index] + 1.f) * AngleScale
+			+ (Rarities[Index] - MinRarity) * RarityScale;
+	}
+
+	// Select, ties keep the order of ActorsToInteract
+	int32 BestIndex = INDEX_NONE;
+	int32 SelectedIndex = INDEX_NONE;
+
+	for (int32 Index = 0; Index < Num; ++Index)
+	{
+		if (!SelectionData.Usable[Index])
+		{
+			continue;
+		}
+
+		if (BestIndex == INDEX_NONE || Scores[Index] > Scores[BestIndex])
+		{
+			BestIndex = Index;
+		}
+
+		if (ActorsToInteract[Index].Component == InteractableInteracted)
+		{
+			SelectedIndex = Index;
+		}
+	}
+
+	// The selected interactable is kept until another candidate beats it by more than the hysteresis
+	if (SelectedIndex != INDEX_NONE && Scores[SelectedIndex] + SelectionHysteresis >= Scores[BestIndex])
+	{
+		BestIndex = SelectedIndex;
+	}
+
+	ScoredCandidate = ActorsToInteract[BestIndex].Component;
+
+	// Publish, a running hold keeps its interactable
+	if ((CanSelectOnlyOneInteractable || !InteractableInteracted.IsValid()) && !IsInteracting
+		&& InteractableInteracted != ScoredCandidate)
+	{
+		SetInteractableInteracted(ScoredCandidate.Get());
+		return true;
+	}
+
+	return false;
+}
+
+void UPlayerInteractionComponent::SetInteractableInteracted(UInteractableComponent* Component)
+{
+	if (InteractableInteracted.Get() == Component)
+	{
+		return;
+	}
+
+	InteractableInteracted = Component;
+	TRACE_INTERACTION_EVENT(SelectionChanged, Component, this);
+}
+
+void UPlayerInteractionComponent::BroadcastSelection()
+{
+	if (InteractableInteracted.IsValid())
+	{
+		UInteractionSubsystem::BroadcastEvent(EInteractionEvent::InteractableSelected, InteractableInteracted.Get(), this);
+	}
+}
+
+int32 UPlayerInteractionComponent::FindSelectionIndex(const UInteractableComponent* Component) const
+{
+	const FInteractionCandidate* Candidate = CandidateKeys.Find(Component);
+
+	return Candidate ? Candidate->SelectionIndex : INDEX_NONE;
+}
+
+bool UPlayerInteractionComponent::CanInteractCached(const UInteractableComponent* Component)
+{
+	UpdateSelection();
+
+	const int32 Index = FindSelectionIndex(Component);
+
+	if (Index == INDEX_NONE || !SelectionData.Usable.IsValidIndex(Index))
+	{
+		return Component ? const_cast<UInteractableComponent*>(Component)->CanInteract(GetOwner()) : false;
+	}
+
+	return SelectionData.Usable[Index];
+}
+
+bool UPlayerInteractionComponent::IsReachableCached(const UInteractableComponent* Component)
+{
+	UpdateSelection();
+
+	const int32 Index = FindSelectionIndex(Component);
+
+	if (Index == INDEX_NONE || !SelectionData.Reachable.IsValidIndex(Index))
+	{
+		return Component ? Component->CheckReachability(GetOwner()) : false;
+	}
+
+	return SelectionData.Reachable[Index];
+}
+
+void UPlayerInteractionComponent::GatherEvaluationView(FInteractionEvaluationView& OutView, bool bTraceLookAt) const
+{
+	const AActor* Owner = GetOwner();
+
+	OutView.Player = Owner;
+	OutView.bHasPlayerComponent = true;
+	OutView.bFirstPerson = bIsUsingFirstPersonMode;
+	OutView.bHasToLookAt = bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle;
+
+	if (!Owner || !GetWorld())
+	{
+		OutView.AngleFailure = TEXT("Owner");
+		return;
+	}
+
+	OutView.PawnLocation = Owner->GetActorLocation();
+	OutView.SelectionLocation = OutView.PawnLocation;
+	OutView.SelectionDirection = PlayerArrow.IsValid() ? PlayerArrow->GetForwardVector()
+		: Owner->GetActorForwardVector();
+
+	if (PWN.IsValid() && bIsUsingFirstPersonMode)
+	{
+		OutView.SelectionLocation = PWN->GetPawnViewLocation();
+		OutView.SelectionDirection = PWN->GetBaseAimRotation().Vector();
+	}
+
+	if (!bIsUsingFirstPersonMode)
+	{
+		if (!PlayerArrow.IsValid())
+		{
+			OutView.AngleFailure = TEXT("Arrow");
+			return;
+		}
+
+		OutView.ArrowForward = PlayerArrow->GetForwardVector().GetSafeNormal();
+		return;
+	}
+
+	APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetWorld(), 0);
+
+	if (!PlayerController)
+	{
+		OutView.AngleFailure = TEXT("PlayerController");
+		return;
+	}
+
+	if (bPlayerHasToLookOnTheObjectInsteadOfCheckingAngle)
+	{
+		APlayerCameraManager* PCM = UGameplayStatics::GetPlayerCameraManager(GetWorld(), 0);
+
+		if (!PCM)
+		{
+			OutView.AngleFailure = TEXT("PlayerCameraManager");
+			return;
+		}
+
+		if (!bTraceLookAt)
+		{
+			return;
+		}
+
+		FHitResult HitResult(ForceInit);
+
+		FCollisionQueryParams CamTraceParams = FCollisionQueryParams(FName(
+			TEXT("InteractionTrace")), true);
+		CamTraceParams.bTraceComplex = true;
+		CamTraceParams.bReturnPhysicalMaterial = true;
+		CamTraceParams.AddIgnoredActor(Owner);
+
+		const FVector TraceStart = PCM->GetCameraLocation();
+		const FVector TraceEnd = TraceStart + PCM->GetCameraRotation().Vector() * 1000000.f;
+
+		INTERACTION_INC_TRACES();
+		GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_Camera,
+			CamTraceParams);
+
+		OutView.LookedAtActor = HitResult.bBlockingHit ? HitResult.GetActor() : nullptr;
+		return;
+	}
+
+	// Same projection as UGameplayStatics::ProjectWorldToScreen, applied to every candidate by the evaluation
+	const ULocalPlayer* LocalPlayer = PlayerController->GetLocalPlayer();
+	FSceneViewProjectionData ProjectionData;
+
+	if (LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->GetProjectionData(
+		LocalPlayer->ViewportClient->Viewport, eSSP_FULL, ProjectionData))
+	{
+		OutView.ViewProjectionMatrix = ProjectionData.ComputeViewProjectionMatrix();
+		OutView.ViewRect = ProjectionData.GetConstrainedViewRect();
+		OutView.bHasViewport = true;
+	}
+
+	int32 ViewportX;
+	int32 ViewportY;
+
+	PlayerController->GetViewportSize(ViewportX, ViewportY);
+
+	OutView.ScreenCenter = { ViewportX * 0.5f, ViewportY * 0.5f };
+	OutView.ScreenCenter.Normalize();
+}
+
+bool UPlayerInteractionComponent::GatherSnapshotView(const FInteractionPlayerSnapshot& Snapshot,
+	FInteractionEvaluationView& OutView) const
+{
+	if (ClientViewSize.X <= 0 || ClientViewSize.Y <= 0)
+	{
+		return false;
+	}
+
+	// Same projection as FMinimalViewInfo with a horizontal field of view
+	const float HalfFieldOfView = FMath::DegreesToRadians(FMath::Clamp(ClientFieldOfView, 1.f, 170.f)) * 0.5f;
+
+	const FMatrix ViewRotationMatrix = FInverseRotationMatrix(Snapshot.ViewRotation) * FMatrix(
+		FPlane(0.f, 0.f, 1.f, 0.f),
+		FPlane(1.f, 0.f, 0.f, 0.f),
+		FPlane(0.f, 1.f, 0.f, 0.f),
+		FPlane(0.f, 0.f, 0.f, 1.f));
+
+	const FMatrix ProjectionMatrix = FReversedZPerspectiveMatrix(HalfFieldOfView, HalfFieldOfView, 1.f,
+		static_cast<float>(ClientViewSize.X) / ClientViewSize.Y, GNearClippingPlane, GNearClippingPlane);
+
+	OutView.Player = GetOwner();
+	OutView.PawnLocation = Snapshot.PawnLocation;
+	OutView.bHasPlayerComponent = true;
+	OutView.bFirstPerson = true;
+	OutView.ViewProjectionMatrix = FTranslationMatrix(-Snapshot.ViewLocation) * ViewRotationMatrix * ProjectionMatrix;
+	OutView.ViewRect = FIntRect(FIntPoint::ZeroValue, ClientViewSize);
+	OutView.bHasViewport = true;
+	OutView.ScreenCenter = { ClientViewSize.X * 0.5f, ClientViewSize.Y * 0.5f };
+	OutView.ScreenCenter.Normalize();
+
+	return true;
+}
+
+void UPlayerInteractionComponent::UpdateClientView()
+{
+	// The server validates first person angles against the owning client's view
+	if (!bIsUsingFirstPersonMode || GetOwnerRole() != ROLE_AutonomousProxy)
+	{
+		return;
+	}
+
+	const APlayerController* PlayerController = PWN.IsValid() ? Cast<APlayerController>(PWN->GetController())
+		: nullptr;
+
+	if (!PlayerController || !PlayerController->PlayerCameraManager)
+	{
+		return;
+	}
+
+	int32 ViewportX;
+	int32 ViewportY;
+
+	PlayerController->GetViewportSize(ViewportX, ViewportY);
+
+	const FIntPoint ViewSize(ViewportX, ViewportY);
+	const float FieldOfView = PlayerController->PlayerCameraManager->GetFOVAngle();
+
+	if (ViewSize == ClientViewSize && FMath::IsNearlyEqual(FieldOfView, ClientFieldOfView, 0.1f))
+	{
+		return;
+	}
+
+	ClientViewSize = ViewSize;
+	ClientFieldOfView = FieldOfView;
+
+	SetClientViewOn_Server(ViewSize, FieldOfView);
+}
+
+bool UPlayerInteractionComponent::SetClientViewOn_Server_Validate(FIntPoint ViewSize, float FieldOfView)
+{
+	return ViewSize.X >= 0 && ViewSize.Y >= 0 && FieldOfView > 0.f && FieldOfView < 180.f;
+}
+
+void UPlayerInteractionComponent::SetClientViewOn_Server_Implementation(FIntPoint ViewSize, float FieldOfView)
+{
+	++ServerRPCCount;
+
+	ClientViewSize = ViewSize;
+	ClientFieldOfView = FieldOfView;
+}
+
+UInteractableComponent* UPlayerInteractionComponent::GetScoredCandidate()
+{
+	UpdateSelection();
+
+	return ScoredCandidate.Get();
+}
+
+void UPlayerInteractionComponent::DrawDebugOverlay(UCanvas* Canvas, bool bLabels) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionDrawDebugOverlay);
+
+	if (!Canvas || !GetOwner() || !GEngine)
+	{
+		return;
+	}
+
+	static const TCHAR* ResultNames[] =
+	{
+		TEXT("Not Evaluated"), TEXT("Usable"), TEXT("Disabled"), TEXT("Too Far"), TEXT("Unreachable"), TEXT("Wrong Angle")
+	};
+
+	static const float Columns[] = { 0.f, 220.f, 280.f, 360.f, 450.f, 520.f, 600.f };
+
+	UFont* Font = GEngine->GetSmallFont();
+	const FVector PlayerLocation = GetOwner()->GetActorLocation();
+	const float X = 50.f;
+	float Y = 50.f;
+
+	const auto DrawRow = [Canvas, Font, X, &Y](const FString (&Cells)[7], const FColor& Color)
+	{
+		Canvas->SetDrawColor(Color);
+
+		float Height = 0.f;
+
+		for (int32 Column = 0; Column < UE_ARRAY_COUNT(Columns); ++Column)
+		{
+			Height = FMath::Max(Height, Canvas->DrawText(Font, Cells[Column], X + Columns[Column], Y));
+		}
+
+		Y += Height;
+	};
+
+	if (!bLabels)
+	{
+		Canvas->SetDrawColor(FColor::White);
+		Y += Canvas->DrawText(Font, FString::Printf(TEXT("Interaction candidates of %s: %d"), *GetOwner()->GetName(),
+			ActorsToInteract.Num()), X, Y);
+
+		const FString Header[] = { TEXT("Interactable"), TEXT("Priority"), TEXT("Distance"), TEXT("Reachable"),
+			TEXT("Angle"), TEXT("Score"), TEXT("Result") };
+
+		DrawRow(Header, FColor::White);
+	}
+
+	// Scores belong to the last selection pass, they are only valid while the candidates didn't change since
+	const bool bHasScores = SelectionData.Scores.Num() == ActorsToInteract.Num();
+	const TObjectKey<AActor> PlayerKey(GetOwner());
+
+	for (int32 Index = 0; Index < ActorsToInteract.Num(); ++Index)
+	{
+		const UInteractableComponent* Component = ActorsToInteract[Index].Component.Get();
+
+		if (!Component)
+		{
+			continue;
+		}
+
+		const FInteractionEvaluation& Evaluation = Component->GetLastEvaluation();
+		const bool bEvaluated = Evaluation.Player == PlayerKey;
+		const EInteractionEvaluationResult Result = bEvaluated ? Evaluation.Result
+			: EInteractionEvaluationResult::NotEvaluated;
+		const bool bAngleChecked = bEvaluated && Evaluation.bAngleChecked;
+		const bool bScored = bHasScores && SelectionData.Usable[Index];
+		const bool bSelected = InteractableInteracted.Get() == Component;
+		const FColor& Color = Result == EInteractionEvaluationResult::Usable ? DSProperties.ValidTextColor
+			: DSProperties.InvalidTextColor;
+
+		// Only the distance is cheap enough to be measured here, everything else comes from the evaluation
+		const float Distance = FVector::Dist(Component->GetComponentLocation(), PlayerLocation);
+
+		if (bLabels)
+		{
+			const FVector ScreenLocation = Canvas->Project(Component->GetComponentLocation());
+
+			if (ScreenLocation.Z <= 0.f)
+			{
+				continue;
+			}
+
+			Canvas->SetDrawColor(Color);
+			Canvas->DrawText(Font, FString::Printf(TEXT("%s%s  %s  P %d  D %.0f%s%s"), bSelected ? TEXT("> ") : TEXT(""),
+				*GetNameSafe(Component->GetOwner()), ResultNames[static_cast<int32>(Result)], Component->GetPriority(),
+				Distance, bAngleChecked ? *FString::Printf(TEXT("  A %.1f"), Evaluation.Angle) : TEXT(""),
+				bScored ? *FString::Printf(TEXT("  S %.2f"), SelectionData.Scores[Index]) : TEXT("")),
+				ScreenLocation.X, ScreenLocation.Y);
+
+			continue;
+		}
+
+		const FString Row[] =
+		{
+			FString::Printf(TEXT("%s%s"), bSelected ? TEXT("> ") : TEXT(""), *GetNameSafe(Component->GetOwner())),
+			FString::FromInt(Component->GetPriority()),
+			FString::Printf(TEXT("%.0f"), Distance),
+			!bEvaluated || !Evaluation.bReachabilityChecked ? FString(TEXT("-")) : Evaluation.bReachable ? FString(TEXT("Yes"))
+				: FString(TEXT("No")),
+			bAngleChecked ? FString::Printf(TEXT("%.1f"), Evaluation.Angle) : FString(TEXT("-")),
+			bScored ? FString::Printf(TEXT("%.2f"), SelectionData.Scores[Index]) : FString(TEXT("-")),
+			ResultNames[static_cast<int32>(Result)]
+		};
+
+		DrawRow(Row, Color);
+	}
+}
+
+void UPlayerInteractionComponent::AddMemoryUsage(FInteractionMemoryReport& Report) const
+{
+	Report.AddObject(Report.Components, this);
+
+	Report.AddWidget(InteractionWidgetName.Get());
+	Report.AddWidget(InteractionWidgetBase.Get());
+	Report.AddWidget(InteractionWidgetOnInteractable.Get());
+	Report.AddWidget(InteractionMarker.Get());
+	Report.AddWidget(InteractionProgressWidget.Get());
+
+	// Pairs are counted on the interactable side, only the player's containers are added here
+	Report.Subscriptions.Add(0, ActorsToInteract.GetAllocatedSize() + CandidateKeys.GetAllocatedSize()
+		+ SelectionData.Priorities.GetAllocatedSize() + SelectionData.Distances.GetAllocatedSize()
+		+ SelectionData.ViewDots.GetAllocatedSize() + SelectionData.Rarities.GetAllocatedSize()
+		+ SelectionData.Scores.GetAllocatedSize() + SelectionData.Usable.GetAllocatedSize()
+		+ SelectionData.Reachable.GetAllocatedSize()
+		+ LightweightCandidates.GetAllocatedSize());
+
+	Report.Caches.Add(1, ServerCandidates.GetAllocatedSize() + PendingLatencySamples.GetAllocatedSize());
+}
+
+bool UPlayerInteractionComponent::CanInteractWithLightweight(const UInteractionSubsystem& Subsystem,
+	const FInteractionHandle& Handle, const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	const FInteractable* Settings = Subsystem.GetLightweightSettings(Handle);
+
+	if (!Settings || !Subsystem.IsLightweightInteractableUsable(Handle))
+	{
+		return false;
+	}
+
+	const FVector Location = Subsystem.GetLightweightLocation(Handle);
+
+	if (Settings->bDoesDistanceToPlayerMatter)
+	{
+		const float Reach = Settings->MaximumDistanceToPlayer + GetOwner()->GetSimpleCollisionRadius();
+
+		if (FVector::DistSquared(GetOwner()->GetActorLocation(), Location) > Reach * Reach)
+		{
+			return false;
+		}
+	}
+
+	if (Settings->bDoesAngleMatter)
+	{
+		const float Dot = FVector::DotProduct(ViewDirection, (Location - ViewLocation).GetSafeNormal());
+
+		if (FMath::Acos(FMath::Clamp(Dot, -1.f, 1.f)) * Multiplier > Settings->PlayersAngleMarginOfErrorToInteractable)
+		{
+			return false;
+		}
+	}
+
+	if (Settings->bHasToBeReacheable)
+	{
+		FCollisionQueryParams CollisionParams;
+		CollisionParams.AddIgnoredActor(GetOwner());
+
+		FHitResult OutHit;
+
+		INTERACTION_INC_TRACES();
+
+		// The backing instance is allowed to block, anything else in between makes the item unreachable
+		if (GetWorld()->LineTraceSingleByChannel(OutHit, ViewLocation, Location, ECC_Visibility, CollisionParams))
+		{
+			int32 InstanceIndex;
+			const UInstancedStaticMeshComponent* InstanceComponent = Subsystem.GetLightweightInstance(Handle,
+				InstanceIndex);
+
+			if (!InstanceComponent || OutHit.Component.Get() != InstanceComponent || OutHit.Item != InstanceIndex)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void UPlayerInteractionComponent::UpdateLightweightCandidates()
+{
+	INTERACTION_BENCHMARK_SCOPE();
+
+	if (!PWN.IsValid() || !PWN->IsLocallyControlled() || !GetWorld())
+	{
+		return;
+	}
+
+	const UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+	const FInteractionHandle PreviousSelection = SelectedLightweight;
+
+	LightweightCandidates.Reset();
+	SelectedLightweight.Reset();
+
+	if (Subsystem && Subsystem->GetNumLightweightInteractables())
+	{
+		const FVector ViewLocation = PWN->GetPawnViewLocation();
+		const FVector ViewDirection = PlayerArrow.IsValid() && !bIsUsingFirstPersonMode
+			? PlayerArrow->GetForwardVector() : PWN->GetBaseAimRotation().Vector();
+		const FVector PlayerLocation = GetOwner()->GetActorLocation();
+
+		Subsystem->QueryLightweightInteractables(PlayerLocation, GetOwner()->GetSimpleCollisionRadius(),
+			[this](const FInteractionHandle& Handle)
+			{
+				LightweightCandidates.Add(Handle);
+			});
+
+		int32 BestPriority = 0;
+		float BestDistanceSquared = MAX_flt;
+
+		// Priority first, then distance, the previous selection wins ties
+		for (const FInteractionHandle& Handle : LightweightCandidates)
+		{
+			if (!CanInteractWithLightweight(*Subsystem, Handle, ViewLocation, ViewDirection))
+			{
+				continue;
+			}
+
+			const int32 Priority = Subsystem->GetLightweightSettings(Handle)->Priority;
+			const float DistanceSquared = FVector::DistSquared(PlayerLocation, Subsystem->GetLightweightLocation(Handle));
+			bool bIsBetter;
+
+			if (!SelectedLightweight.IsValid())
+			{
+				bIsBetter = true;
+			}
+			else if (Priority != BestPriority)
+			{
+				bIsBetter = bUseLowerPriorityFirst ? Priority < BestPriority : Priority > BestPriority;
+			}
+			else
+			{
+				bIsBetter = SelectedLightweight != PreviousSelection
+					&& (Handle == PreviousSelection || DistanceSquared < BestDistanceSquared);
+			}
+
+			if (bIsBetter)
+			{
+				SelectedLightweight = Handle;
+				BestPriority = Priority;
+				BestDistanceSquared = DistanceSquared;
+			}
+		}
+	}
+
+	// Interactable components own the interaction widget while any of them is in reach
+	const bool bShowWidget = SelectedLightweight.IsValid() && !ActorsToInteract.Num();
+
+	if (bShowWidget && (!bShowingLightweightWidget || SelectedLightweight != PreviousSelection))
+	{
+		if (InteractionWidgetBP)
+		{
+			ShowInteractionWidget(InteractionWidgetBP);
+
+			if (InteractionWidgetBase.IsValid())
+			{
+				InteractionWidgetBase->OnTextChanged(Subsystem->GetLightweightSettings(SelectedLightweight)->InteractionText);
+			}
+		}
+	}
+	else if (!bShowWidget && bShowingLightweightWidget && !ActorsToInteract.Num())
+	{
+		HideInteractionWidget();
+	}
+
+	bShowingLightweightWidget = bShowWidget;
+}
+
+bool UPlayerInteractionComponent::TryInteractWithLightweight(bool bOnline)
+{
+	UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this);
+
+	if (!Subsystem || !Subsystem->IsLightweightInteractableUsable(SelectedLightweight))
+	{
+		return false;
+	}
+
+	RecordInputLatency();
+
+	if (bOnline)
+	{
+		int32 InstanceIndex = INDEX_NONE;
+		UInstancedStaticMeshComponent* InstanceComponent = Subsystem->GetLightweightInstance(SelectedLightweight,
+			InstanceIndex);
+
+		InteractWithLightweightOn_Server(SelectedLightweight, InstanceComponent, InstanceIndex, GetServerWorldTime());
+	}
+	else
+	{
+		Subsystem->ExecuteLightweightInteraction(this, SelectedLightweight);
+		RecordLocalTotalLatency(0.f);
+	}
+
 	return true;
 }
 
-void UPlayerInteractionComponent::InteractWithInteractablesOn_Server_Implementation(
-	UInteractableComponent* ActorToInteract)
+bool UPlayerInteractionComponent::InteractWithLightweightOn_Server_Validate(FInteractionHandle Handle,
+	UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex, float ClientTimeStamp)
 {
-	if (!ActorToInteract)
-	{
-		return;
-	}
-
-	ExecuteInteract(ActorToInteract);
+	return true;
 }
 
-void UPlayerInteractionComponent::InteractWithInteractablesOnServer()
- {
-	StopInteraction();
-	IsOnlineInteracting = true;
+void UPlayerInteractionComponent::InteractWithLightweightOn_Server_Implementation(FInteractionHandle Handle,
+	UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex, float ClientTimeStamp)
+{
+	++ServerRPCCount;
 
-	if (ActorsToInteract.Num() > 0)
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
 	{
-		if (CanSelectOnlyOneInteractable && InteractableInteracted.IsValid() && 
-			InteractableInteracted.Get()->CanInteract(GetOwner()))
-		{
-			if (InteractableInteracted.Get()->InteractableStructure.bHoldButtonToInteract)
-			{
-				TryShowInteractionProgress(InteractableInteracted.Get());
-				IsInteracting = true;
-				SetComponentTickEnabled(true);
-			}
-			else
-			{
-				InteractWithInteractablesOn_Server(InteractableInteracted.Get());
-				return;
-			}
-		}
-
-		for (const auto& ActorToInteract : ActorsToInteract)
-		{
-			if (ActorToInteract->CanInteract(GetOwner()))
-			{
-				if (ActorToInteract.Get()->InteractableStructure.bHoldButtonToInteract)
-				{
-					InteractableInteracted = ActorToInteract;
-					TryShowInteractionProgress(InteractableInteracted.Get());
-					IsInteracting = true;
-					SetComponentTickEnabled(true);
-				}
-				else
-				{
-					InteractWithInteractablesOn_Server(ActorToInteract.Get());
-				}
-			}
-		}
+		Subsystem->EnqueueLightweightInteraction(this,
+			Subsystem->ResolveLightweightInstance(Handle, InstanceComponent, InstanceIndex), ClientTimeStamp);
 	}
 }
 
-void UPlayerInteractionComponent::SortActors()
+void UPlayerInteractionComponent::LightweightUsedOn_Client_Implementation(FInteractionHandle Handle,
+	UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex)
 {
-	ActorsToInteract.Sort([=](const TWeakObjectPtr<UInteractableComponent>& LHS,
-		const TWeakObjectPtr<UInteractableComponent>& RHS)
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
 	{
-		return bUseLowerPriorityFirst ? LHS.Get()->GetPriority() < RHS.Get()->GetPriority()
-			: LHS.Get()->GetPriority() > RHS.Get()->GetPriority();
-	});
+		Subsystem->MarkLightweightUsed(Subsystem->ResolveLightweightInstance(Handle, InstanceComponent, InstanceIndex));
+	}
 }
 
 void UPlayerInteractionComponent::TryExecuteInteract(const TWeakObjectPtr<UInteractableComponent>& Actor)
@@ -300,18 +1594,17 @@ void UPlayerInteractionComponent::TryExecuteInteract(const TWeakObjectPtr<UInter
 
 	if (Actor.Get()->CanInteract(GetOwner()))
 	{
-		if (Actor.Get()->InteractableStructure.bHoldButtonToInteract)
+		if (Actor.Get()->GetSettings().bHoldButtonToInteract)
 		{
-			StopInteraction();
-			InteractableInteracted = Actor.Get();
-			TryShowInteractionProgress(InteractableInteracted.Get());
-			IsInteracting = true;
-			SetComponentTickEnabled(true);
+			StopInteractionInternal();
+			StartHold(Actor.Get());
 			return;
 		}
 		else
 		{
+			RecordInputLatency();
 			ExecuteInteract(Actor.Get());
+			RecordLocalTotalLatency(0.f);
 			return;
 		}
 	}
@@ -319,22 +1612,27 @@ void UPlayerInteractionComponent::TryExecuteInteract(const TWeakObjectPtr<UInter
 
 void UPlayerInteractionComponent::InteractWithInteractables()
 {
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RecordReplayInput(this, EInteractionReplayInput::Interact);
+	}
+
+	IsOnlineInteracting = false;
+	BeginLatencySample();
+
 	if (ActorsToInteract.Num() > 0)
 	{
 		if (CanSelectOnlyOneInteractable && InteractableInteracted.IsValid())
 		{
 			if (!InteractableInteracted.Get()->CanInteract(GetOwner()))
 			{
-				StopInteraction();
+				StopInteractionInternal();
+				UpdateSelection(true);
 
-				for (auto& Act : ActorsToInteract)
+				if (ScoredCandidate.IsValid())
 				{
-					if (Act->CanInteract(GetOwner()))
-					{
-						InteractableInteracted = Act;
-						TryExecuteInteract(InteractableInteracted.Get());
-						return;
-					}
+					SetInteractableInteracted(ScoredCandidate.Get());
+					TryExecuteInteract(InteractableInteracted.Get());
 				}
 			}
 			else
@@ -345,15 +1643,15 @@ void UPlayerInteractionComponent::InteractWithInteractables()
 			return;
 		}
 
-		for (const auto& ActorToInteract : ActorsToInteract)
+		if (UInteractableComponent* Selected = GetScoredCandidate())
 		{
-			if(ActorToInteract->CanInteract(GetOwner()))
-			{
-				TryExecuteInteract(InteractableInteracted.Get());
-				return;
-			}
+			TryExecuteInteract(Selected);
 		}
 	}
+	else
+	{
+		TryInteractWithLightweight(false);
+	}
 }
 
 void UPlayerInteractionComponent::ExecuteInteract(const TWeakObjectPtr<UInteractableComponent>& Actor)
@@ -363,17 +1661,211 @@ void UPlayerInteractionComponent::ExecuteInteract(const TWeakObjectPtr<UInteract
 		return;
 	}
 
-	if (Actor.Get()->InteractableStructure.bDisableAfterUsage)
+	const double StartTime = UInteractionSubsystem::IsLatencyTelemetryEnabled() ? FPlatformTime::Seconds() : 0.0;
+
+	if (Actor.Get()->GetSettings().bDisableAfterUsage)
 	{
 		Actor.Get()->Disable();
 	}
 
 	Actor.Get()->Interact(this);
+
+	if (StartTime > 0.0)
+	{
+		if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+		{
+			Subsystem->RecordLatency(EInteractionLatencyStage::Execute,
+				static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0));
+		}
+	}
+}
+
+void UPlayerInteractionComponent::StartHold(UInteractableComponent* Component)
+{
+	if (!Component)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Component passed to StartHold() is nullptr."));
+		return;
+	}
+
+	SetInteractableInteracted(Component);
+	TryShowInteractionProgress(Component);
+	IsInteracting = true;
+	HoldStartTime = GetServerWorldTime();
+	SetComponentTickEnabled(true);
+
+	if (IsOnlineInteracting)
+	{
+		IsHoldingOnServer = true;
+		TrackSentRequest(Component, Component->GetSettings().TimeInSecondsForButtonHold);
+		StartHoldOn_Server(Component, HoldStartTime);
+	}
+	else
+	{
+		RecordInputLatency();
+		BeginHoldTimer(Component, HoldStartTime);
+	}
+}
+
+void UPlayerInteractionComponent::BeginHoldTimer(UInteractableComponent* Component, float StartTime)
+{
+	if (!Component || !GetWorld())
+	{
+		return;
+	}
+
+	const float Duration = FMath::Max(Component->GetSettings().TimeInSecondsForButtonHold, KINDA_SMALL_NUMBER);
+	const float AlreadyHeld = FMath::Max(GetServerWorldTime() - StartTime, 0.f);
+
+	HeldInteractable = Component;
+	HoldTimerStartTime = UInteractionSubsystem::IsLatencyTelemetryEnabled()
+		? FPlatformTime::Seconds() - AlreadyHeld : 0.0;
+
+	GetWorld()->GetTimerManager().SetTimer(HoldTimerHandle, this, &UPlayerInteractionComponent::OnHoldTimerCompleted,
+		Duration, Component->GetSettings().CanHoldMultipleTimes, FMath::Max(Duration - AlreadyHeld, KINDA_SMALL_NUMBER));
+}
+
+void UPlayerInteractionComponent::ClearHoldTimer()
+{
+	if (GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(HoldTimerHandle);
+	}
+
+	HeldInteractable.Reset();
+	IsHoldTimedForClient = false;
+}
+
+void UPlayerInteractionComponent::OnHoldTimerCompleted()
+{
+	UInteractableComponent* Component = HeldInteractable.Get();
+
+	// Only the first completion of a repeated hold is measured
+	if (HoldTimerStartTime > 0.0 && Component)
+	{
+		if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+		{
+			const double HeldSeconds = FPlatformTime::Seconds() - HoldTimerStartTime;
+
+			Subsystem->RecordLatency(EInteractionLatencyStage::Hold,
+				static_cast<float>((HeldSeconds - Component->GetSettings().TimeInSecondsForButtonHold) * 1000.0));
+		}
+
+		HoldTimerStartTime = 0.0;
+	}
+
+	if (IsHoldTimedForClient)
+	{
+		// Completion competes with other requests in the interaction subsystem batch, a rejection stops the hold
+		if (Component)
+		{
+			if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+			{
+				Subsystem->EnqueueInteraction(this, Component, GetServerWorldTime(), HoldReceiveTime);
+			}
+
+			HoldReceiveTime = 0.0;
+
+			if (Component->GetSettings().CanHoldMultipleTimes && !Component->bDisabled)
+			{
+				return;
+			}
+		}
+
+		ClearHoldTimer();
+		++ClientRPCCount;
+		HoldStoppedOn_Client();
+		return;
+	}
+
+	const bool bCanComplete = Component && Component->CanInteract(GetOwner());
+
+	if (bCanComplete)
+	{
+		ExecuteInteract(Component);
+		RecordLocalTotalLatency(Component->GetSettings().TimeInSecondsForButtonHold);
+	}
+
+	if (bCanComplete && Component->GetSettings().CanHoldMultipleTimes
+		&& !Component->bDisabled)
+	{
+		return;
+	}
+
+	ClearHoldTimer();
+	StopInteractionInternal();
+}
+
+bool UPlayerInteractionComponent::StartHoldOn_Server_Validate(UInteractableComponent* ActorToInteract,
+	float ClientTimeStamp)
+{
+	return true;
+}
+
+void UPlayerInteractionComponent::StartHoldOn_Server_Implementation(UInteractableComponent* ActorToInteract,
+	float ClientTimeStamp)
+{
+	++ServerRPCCount;
+
+	ClearHoldTimer();
+	HoldReceiveTime = FPlatformTime::Seconds();
+
+	if (!ActorToInteract || !ActorToInteract->GetSettings().bHoldButtonToInteract
+		|| !ValidateInteractionAtTime(ActorToInteract, ClientTimeStamp))
+	{
+		++ClientRPCCount;
+		HoldStoppedOn_Client();
+		return;
+	}
+
+	const float ServerTime = GetServerWorldTime();
+	const float StartTime = bUseLagCompensation
+		? FMath::Clamp(ClientTimeStamp, ServerTime - MaximumRewindTime, ServerTime) : ServerTime;
+
+	IsHoldTimedForClient = true;
+	BeginHoldTimer(ActorToInteract, StartTime);
+
+	++ClientRPCCount;
+	HoldStartedOn_Client(ActorToInteract, StartTime);
+}
+
+bool UPlayerInteractionComponent::StopHoldOn_Server_Validate()
+{
+	return true;
+}
+
+void UPlayerInteractionComponent::StopHoldOn_Server_Implementation()
+{
+	++ServerRPCCount;
+
+	ClearHoldTimer();
+}
+
+void UPlayerInteractionComponent::HoldStartedOn_Client_Implementation(UInteractableComponent* ActorToInteract,
+	float ServerStartTime)
+{
+	if (IsInteracting && InteractableInteracted.IsValid() && InteractableInteracted.Get() == ActorToInteract)
+	{
+		HoldStartTime = ServerStartTime;
+	}
+}
+
+void UPlayerInteractionComponent::HoldStoppedOn_Client_Implementation()
+{
+	IsHoldingOnServer = false;
+
+	if (IsInteracting)
+	{
+		StopInteractionInternal();
+	}
 }
 
 void UPlayerInteractionComponent::ShowInteractableName(TSubclassOf<UNameWidget>& WidgetClass, 
 	UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionShowName);
+	INTERACTION_LLM_SCOPE(Widgets);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -393,7 +1885,9 @@ void UPlayerInteractionComponent::ShowInteractableName(TSubclassOf<UNameWidget>&
 		&& PC.IsValid()
 		&& PC->IsLocalPlayerController())
 	{
+		INTERACTION_INC_CREATED_WIDGETS();
 		InteractionWidgetName = CreateWidget<UNameWidget>(PC.Get(), WidgetClass);
+		TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 		if (InteractionWidgetName.IsValid())
 		{
@@ -414,7 +1908,9 @@ void UPlayerInteractionComponent::ShowInteractableName(TSubclassOf<UNameWidget>&
 
 		if (PC.IsValid() && PC->IsLocalPlayerController())
 		{
+			INTERACTION_INC_CREATED_WIDGETS();
 			InteractionWidgetName = CreateWidget<UNameWidget>(PC.Get(), WidgetClass);
+			TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 			if (InteractionWidgetName.IsValid())
 			{
@@ -429,6 +1925,9 @@ void UPlayerInteractionComponent::ShowInteractionWidgetOnInteractable(
 	TSubclassOf<UInteractionWidgetOnInteractable>& WidgetClass,
 	UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionShowWidgetOnInteractable);
+	INTERACTION_LLM_SCOPE(Widgets);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning, 
@@ -470,7 +1969,9 @@ void UPlayerInteractionComponent::ShowInteractionWidgetOnInteractable(
 		Component->InteractionWidgetOnInteractableClass->
 		GetClass() != WidgetClass && PC.IsValid() && PC->IsLocalPlayerController())
 	{
+		INTERACTION_INC_CREATED_WIDGETS();
 		InteractionWidgetOnInteractable = CreateWidget<UInteractionWidgetOnInteractable>(PC.Get(), WidgetClass);
+		TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 		if (InteractionWidgetOnInteractable.IsValid())
 		{
@@ -486,7 +1987,9 @@ void UPlayerInteractionComponent::ShowInteractionWidgetOnInteractable(
 
 		if (PC.IsValid() && PC->IsLocalPlayerController())
 		{
+			INTERACTION_INC_CREATED_WIDGETS();
 			InteractionWidgetOnInteractable = CreateWidget<UInteractionWidgetOnInteractable>(PC.Get(), WidgetClass);
+			TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 			if (InteractionWidgetOnInteractable.IsValid())
 			{
@@ -509,11 +2012,16 @@ void UPlayerInteractionComponent::ShowInteractionWidgetOnInteractable(
 void UPlayerInteractionComponent::ShowInteractionProgress(
 	TSubclassOf<UInteractionHoldWidget>& WidgetClass)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionShowProgress);
+	INTERACTION_LLM_SCOPE(Widgets);
+
 	if (InteractionProgressWidget.IsValid() && InteractionProgressWidget->GetClass() != WidgetClass && PC.IsValid() &&
 		PC->IsLocalPlayerController())
 	{
+		INTERACTION_INC_CREATED_WIDGETS();
 		InteractionProgressWidget = CreateWidget<UInteractionHoldWidget>(PC.Get(), WidgetClass,
 			TEXT("InteractableProgressWidget"));
+		TRACE_INTERACTION_EVENT(WidgetCreated, InteractableInteracted.Get(), this);
 
 		if (InteractionProgressWidget.IsValid())
 		{
@@ -535,8 +2043,10 @@ void UPlayerInteractionComponent::ShowInteractionProgress(
 
 		if (PC.IsValid() && PC->IsLocalPlayerController())
 		{
+			INTERACTION_INC_CREATED_WIDGETS();
 			InteractionProgressWidget = CreateWidget<UInteractionHoldWidget>(PC.Get(), WidgetClass,
 				TEXT("InteractableProgressWidget"));
+			TRACE_INTERACTION_EVENT(WidgetCreated, InteractableInteracted.Get(), this);
 
 			if (InteractionProgressWidget.IsValid())
 			{
@@ -550,6 +2060,9 @@ void UPlayerInteractionComponent::ShowInteractionProgress(
 void UPlayerInteractionComponent::ShowInteractionMarker(TSubclassOf<UUserWidget>& WidgetClass, 
 	UInteractableComponent* Component)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionShowMarker);
+	INTERACTION_LLM_SCOPE(Widgets);
+
 	if (!Component)
 	{
 		UE_LOG(InteractionSystem, Warning,
@@ -571,7 +2084,9 @@ void UPlayerInteractionComponent::ShowInteractionMarker(TSubclassOf<UUserWidget>
 		&& PC.IsValid() && PC->IsLocalPlayerController())
 	{
 
+		INTERACTION_INC_CREATED_WIDGETS();
 		InteractionMarker = CreateWidget<UUserWidget>(PC.Get(), WidgetClass, TEXT("InteractableMarker"));
+		TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 		if (InteractionMarker.IsValid())
 		{
@@ -592,7 +2107,9 @@ void UPlayerInteractionComponent::ShowInteractionMarker(TSubclassOf<UUserWidget>
 
 		if (PC.IsValid() && PC->IsLocalPlayerController())
 		{
+			INTERACTION_INC_CREATED_WIDGETS();
 			InteractionMarker = CreateWidget<UUserWidget>(PC.Get(), WidgetClass, TEXT("InteractableMarker"));
+			TRACE_INTERACTION_EVENT(WidgetCreated, Component, this);
 
 			if (InteractionMarker.IsValid())
 			{
@@ -604,26 +2121,34 @@ void UPlayerInteractionComponent::ShowInteractionMarker(TSubclassOf<UUserWidget>
 
 void UPlayerInteractionComponent::ShowInteractionWidget(const TSubclassOf<UInteractableWidget>& WidgetClass)
 {
+	SCOPE_CYCLE_COUNTER(STAT_InteractionShowWidget);
+	INTERACTION_LLM_SCOPE(Widgets);
+
 	if (InteractionWidgetBase.IsValid() && InteractionWidgetBase->GetClass() != WidgetClass && PC.IsValid() &&
 		PC->IsLocalPlayerController())
 	{
+		INTERACTION_INC_CREATED_WIDGETS();
 		InteractionWidgetBase = CreateWidget<UInteractableWidget>(PC.Get(), WidgetClass,
 			TEXT("InteractableWidget"));
+		TRACE_INTERACTION_EVENT(WidgetCreated, InteractableInteracted.Get(), this);
 
 		if (InteractionWidgetBase.IsValid())
 		{
 			if (InteractableInteracted.IsValid())
 			{
 				InteractionWidgetBase->OnTextChanged(
-					InteractableInteracted.Get()->InteractableStructure.InteractionText);
+					InteractableInteracted.Get()->GetSettings().InteractionText);
 			}
 			InteractionWidgetBase->AddToViewport();
 		}
 	}
 	else if (InteractionWidgetBase.IsValid())
 	{
-		InteractionWidgetBase->OnTextChanged(
-			InteractableInteracted.Get()->InteractableStructure.InteractionText);
+		if (InteractableInteracted.IsValid())
+		{
+			InteractionWidgetBase->OnTextChanged(
+				InteractableInteracted.Get()->GetSettings().InteractionText);
+		}
 
 		if (InteractionWidgetBase.Get()->Visibility == ESlateVisibility::Hidden)
 		{
@@ -641,15 +2166,17 @@ void UPlayerInteractionComponent::ShowInteractionWidget(const TSubclassOf<UInter
 
 		if (PC.IsValid() && PC->IsLocalPlayerController())
 		{
+			INTERACTION_INC_CREATED_WIDGETS();
 			InteractionWidgetBase = CreateWidget<UInteractableWidget>(PC.Get(), WidgetClass,
 				TEXT("InteractableWidget"));
+			TRACE_INTERACTION_EVENT(WidgetCreated, InteractableInteracted.Get(), this);
 
 			if (InteractionWidgetBase.IsValid())
 			{
 				if (InteractableInteracted.IsValid())
 				{
 					InteractionWidgetBase->OnTextChanged(
-						InteractableInteracted.Get()->InteractableStructure.InteractionText);
+						InteractableInteracted.Get()->GetSettings().InteractionText);
 				}
 				InteractionWidgetBase->AddToViewport();
 				InteractionWidgetBase->SetVisibility(ESlateVisibility::Visible); //Just to make sure it's Visible
@@ -683,15 +2210,8 @@ void UPlayerInteractionComponent::SetPC()
 
 bool UPlayerInteractionComponent::CanInteractWithAnyInteractable() const
 {
-	for (auto& ActorToInteract : ActorsToInteract)
-	{
-		if (ActorToInteract->CanInteract(GetOwner()))
-		{
-			return true;
-		}
-	}
-
-	return false;
+	// The selection pass only scores a candidate if one of them is usable
+	return const_cast<UPlayerInteractionComponent*>(this)->GetScoredCandidate() != nullptr;
 }
 
 void UPlayerInteractionComponent::TryShowInteractableName(UInteractableComponent* Component)
@@ -703,8 +2223,8 @@ void UPlayerInteractionComponent::TryShowInteractableName(UInteractableComponent
 		return;
 	}
 
-	if (Component->InteractableStructure.bDisabled || 
-		(bHideInteractableNameWhenPlayerCanInteract && Component->CanInteract(GetOwner())))
+	if (Component->bDisabled || 
+		(bHideInteractableNameWhenPlayerCanInteract && CanInteractCached(Component)))
 	{
 		return;
 	}
@@ -725,7 +2245,7 @@ void UPlayerInteractionComponent::TryShowInteractionWidgetOnInteractable(
 		return;
 	}
 
-	if (Component->InteractableStructure.bDisabled)
+	if (Component->bDisabled)
 	{
 		return;
 	}
@@ -746,7 +2266,7 @@ void UPlayerInteractionComponent::TryShowInteractionProgress(
 		return;
 	}
 
-	if (Component->InteractableStructure.bDisabled)
+	if (Component->bDisabled)
 	{
 		return;
 	}
@@ -766,8 +2286,8 @@ void UPlayerInteractionComponent::TryShowInteractionMarker(UInteractableComponen
 		return;
 	}
 
-	if (Component->InteractableStructure.bDisabled || (bHideInteractionMarkerWhenPlayerCanInteract &&
-		Component->CanInteract(GetOwner())))
+	if (Component->bDisabled || (bHideInteractionMarkerWhenPlayerCanInteract &&
+		CanInteractCached(Component)))
 	{
 		return;
 	}
@@ -787,7 +2307,7 @@ void UPlayerInteractionComponent::TryShowInteractionWidget(const UInteractableCo
 		return;
 	}
 
-	if (Component->InteractableStructure.bDisabled)
+	if (Component->bDisabled)
 	{
 		return;
 	}
@@ -820,8 +2340,7 @@ void UPlayerInteractionComponent::AddActorToInteract(const AActor* Actor)
 		}
 	}
 
-	UInteractableComponent* Component = Actor->
-		FindComponentByClass<UInteractableComponent>();
+	UInteractableComponent* Component = UInteractionSubsystem::FindInteractableComponent(Actor);
 
 	if (!Component)
 	{
@@ -830,7 +2349,26 @@ void UPlayerInteractionComponent::AddActorToInteract(const AActor* Actor)
 		return;
 	}
 
-	if (ActorsToInteract.Contains(Component))
+	AddInteractable(Component);
+}
+
+void UPlayerInteractionComponent::AddInteractable(UInteractableComponent* Component)
+{
+	SCOPE_CYCLE_COUNTER(STAT_InteractionAddActorToInteract);
+	INTERACTION_LLM_SCOPE(Subscriptions);
+
+	if (!Component)
+	{
+		UE_LOG(InteractionSystem, Warning, TEXT("Component passed to AddInteractable() is nullptr."));
+		return;
+	}
+
+	if (!PWN.IsValid())
+	{
+		PWN = Cast<APawn>(GetOwner());
+	}
+
+	if (CandidateKeys.Contains(Component))
 	{
 		return;
 	}
@@ -842,104 +2380,203 @@ void UPlayerInteractionComponent::AddActorToInteract(const AActor* Actor)
 		return;
 	}
 
-	ActorsToInteract.Add(Component);
-	Component->InstancedDSP = DSProperties;
+	InsertCandidate(Component);
+	Component->SetDebugPropertiesSource(this);
 
 	if (!InteractableInteracted.IsValid())
 	{
-		StopInteraction();
-		InteractableInteracted = Component;
+		StopInteractionInternal();
+		SetInteractableInteracted(Component);
 	}
 
-	SortActors();
-
 	Component->SetWidgetRotationSettings(bRotateWidgetsTowardsPlayerCamera,
 		bRotateWidgetsTowardsPlayerPawn);
 
 	if (ActorsToInteract.Num() == 1)
 	{
-		if (OnFirstInteractableSubscribedDelegate.IsBound())
-		{
-			OnFirstInteractableSubscribedDelegate.Broadcast(Component->GetOwner());
-		}
+		UInteractionSubsystem::BroadcastEvent(EInteractionEvent::FirstInteractableSubscribed, Component, this);
 	}
 
-	if (OnInteractableSubscribedDelegate.IsBound())
-	{
-		OnInteractableSubscribedDelegate.Broadcast(Component->GetOwner());
-	}
+	UInteractionSubsystem::BroadcastEvent(EInteractionEvent::InteractableSubscribed, Component, this);
 
 	if (CanShowSystemLog)
 	{
 		UE_LOG(InteractionSystem, Log, 
-			TEXT("Added %s to ActorsToInteract for %s player. Amount of actors to interact equals: %d"), *GetNameSafe(Actor), *GetNameSafe(GetOwner()), ActorsToInteract.Num());
+			TEXT("Added %s to ActorsToInteract for %s player. Amount of actors to interact equals: %d"), *GetNameSafe(Component->GetOwner()), *GetNameSafe(GetOwner()), ActorsToInteract.Num());
 	}
 }
 
 void UPlayerInteractionComponent::StopInteraction()
 {
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RecordReplayInput(this, EInteractionReplayInput::StopInteraction);
+	}
+
+	StopInteractionInternal();
+}
+
+void UPlayerInteractionComponent::StopInteractionInternal()
+{
+	if (IsHoldingOnServer)
+	{
+		IsHoldingOnServer = false;
+		StopHoldOn_Server();
+	}
+	else if (!IsHoldTimedForClient)
+	{
+		ClearHoldTimer();
+	}
+
 	IsInteracting = false;
-	CurrentTimeInSecondsForButtonHold = 0.f;
 	HideInteractionProgressWidget();
 	SetComponentTickEnabled(false);
 }
 
+void UPlayerInteractionComponent::OnRegister()
+{
+	INTERACTION_LLM_SCOPE(Components);
+
+	Super::OnRegister();
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->RegisterComponent(this);
+	}
+}
+
+void UPlayerInteractionComponent::OnUnregister()
+{
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->UnregisterComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
 void UPlayerInteractionComponent::BeginPlay()
 {
+	INTERACTION_LLM_SCOPE(Components);
+
 	Super::BeginPlay();
 
 	SetComponentTickEnabled(false);
+
+	PlayerArrow = GetOwner() ? GetOwner()->FindComponentByClass<UArrowComponent>() : nullptr;
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		InteractionIndex = Subsystem->AllocatePlayerIndex();
+
+		if (GetOwnerRole() == ROLE_Authority)
+		{
+			Subsystem->RegisterPlayer(this);
+		}
+	}
+
+	if (bUseLagCompensation && GetOwnerRole() == ROLE_Authority && GetWorld())
+	{
+		RecordHistorySample();
+
+		GetWorld()->GetTimerManager().SetTimer(HistoryTimerHandle, this,
+			&UPlayerInteractionComponent::RecordHistorySample, HistorySampleInterval, true);
+	}
+
+	// Runs on every machine, only the locally controlled player does the work
+	if (GetWorld() && GetNetMode() != NM_DedicatedServer)
+	{
+		GetWorld()->GetTimerManager().SetTimer(LightweightDiscoveryTimerHandle, this,
+			&UPlayerInteractionComponent::UpdateLightweightCandidates, LightweightDiscoveryInterval, true);
+	}
+
+	// The player tick only runs during holds, the view is polled so instant interactions are validated too
+	if (GetWorld() && GetNetMode() == NM_Client)
+	{
+		UpdateClientView();
+
+		GetWorld()->GetTimerManager().SetTimer(ClientViewTimerHandle, this,
+			&UPlayerInteractionComponent::UpdateClientView, ClientViewUpdateInterval, true);
+	}
+}
+
+void UPlayerInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (GetWorld())
+	{
+		GetWorld()->GetTimerManager().ClearTimer(HistoryTimerHandle);
+		GetWorld()->GetTimerManager().ClearTimer(LightweightDiscoveryTimerHandle);
+		GetWorld()->GetTimerManager().ClearTimer(ClientViewTimerHandle);
+	}
+
+	ClearHoldTimer();
+
+	// Copy since unsubscribing modifies ActorsToInteract
+	const TArray<FInteractionCandidate, TInlineAllocator<16>> Candidates = ActorsToInteract;
+
+	for (const FInteractionCandidate& Candidate : Candidates)
+	{
+		if (Candidate.Component.IsValid() && Candidate.Component->GetOwner())
+		{
+			RemoveActorToInteract(Candidate.Component->GetOwner());
+		}
+	}
+
+	ActorsToInteract.Reset();
+	CandidateKeys.Reset();
+
+	if (UInteractionSubsystem* Subsystem = UInteractionSubsystem::Get(this))
+	{
+		Subsystem->UnregisterPlayer(this);
+		Subsystem->ReleasePlayerIndex(InteractionIndex);
+	}
+
+	InteractionIndex = INDEX_NONE;
+
+	PositionHistory.Reset();
+	ServerCandidates.Empty();
+	LightweightCandidates.Reset();
+	SelectedLightweight.Reset();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UPlayerInteractionComponent::TickComponent(float DeltaTime, ELevelTick TickType,
 	FActorComponentTickFunction* ThisTickFunction)
 {
+	INTERACTION_BENCHMARK_SCOPE();
+	SCOPE_CYCLE_COUNTER(STAT_InteractionPlayerTick);
+	TRACE_INTERACTION_SCOPE(Interaction_PlayerTick);
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
 	if (!InteractableInteracted.IsValid())
 	{
-		StopInteraction();
-
-		for (auto& Act : ActorsToInteract)
-		{
-			if (Act->CanInteract(GetOwner()))
-			{
-				InteractableInteracted = Act;
-				break;
-			}
-		}
+		StopInteractionInternal();
+		UpdateSelection(true);
 	}
-	else if (!InteractableInteracted.Get()->CanInteract(GetOwner()) || !IsInteracting)
+	else if (!CanInteractCached(InteractableInteracted.Get()) || !IsInteracting)
 	{
-		InteractableInteracted.Reset();
-		StopInteraction();
+		SetInteractableInteracted(nullptr);
+		StopInteractionInternal();
 		return;
 	}
 
 	if (!InteractionProgressWidget.IsValid() || !InteractableInteracted.IsValid())
 	{
-		StopInteraction();
+		StopInteractionInternal();
 		return;
 	}
 
-	if (InteractableInteracted.Get()->InteractableStructure.TimeInSecondsForButtonHold
-		<= CurrentTimeInSecondsForButtonHold)
-	{
-		IsOnlineInteracting ? InteractWithInteractablesOn_Server(InteractableInteracted.Get()) 
-			: ExecuteInteract(InteractableInteracted.Get());
+	// The hold itself is timed by BeginHoldTimer, the client only interpolates the progress bar
+	const FInteractable& Settings = InteractableInteracted.Get()->GetSettings();
+	const float Duration = FMath::Max(Settings.TimeInSecondsForButtonHold, KINDA_SMALL_NUMBER);
+	float HeldTime = FMath::Max(GetServerWorldTime() - HoldStartTime, 0.f);
 
-		if (InteractableInteracted.IsValid() && InteractableInteracted.Get()->InteractableStructure.CanHoldMultipleTimes)
-		{
-			CurrentTimeInSecondsForButtonHold = 0.f;
-		}
-		else
-		{
-			StopInteraction();
-		}
-	}
-	else
+	if (Settings.CanHoldMultipleTimes)
 	{
-		CurrentTimeInSecondsForButtonHold += DeltaTime;
-		InteractionProgressWidget.Get()->OnHoldCalled(CurrentTimeInSecondsForButtonHold / InteractableInteracted.Get()->InteractableStructure.TimeInSecondsForButtonHold);
+		HeldTime = FMath::Fmod(HeldTime, Duration);
 	}
+
+	InteractionProgressWidget.Get()->OnHoldCalled(FMath::Clamp(HeldTime / Duration, 0.f, 1.f));
 }
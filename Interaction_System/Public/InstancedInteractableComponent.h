@@ -0,0 +1,90 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "InteractionLightweight.h"
+
+#include "InstancedInteractableComponent.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UInteractableDefinition;
+class UPlayerInteractionComponent;
+struct FInteractionMemoryReport;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInstancedInteractableDelegate, int32, InstanceIndex, AActor*, Player);
+
+/*Makes every instance of an instanced static mesh (or HISM) interactable without a UObject per instance.
+Instances are registered as lightweight interactables of UInteractionSubsystem, their reachability is traced
+against the instance itself. Instances are read on BeginPlay, call RefreshInstances after adding or removing
+instances at runtime.*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent), Blueprintable)
+class INTERACTIONSYSTEM_API UInstancedInteractableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+private:
+
+	// Handle of every instance, indexed by instance index
+	TArray<FInteractionHandle> InstanceHandles;
+
+	FDelegateHandle InteractedDelegateHandle;
+
+	FDelegateHandle UsedDelegateHandle;
+
+	void RegisterInstances();
+
+	void UnregisterInstances();
+
+	void OnLightweightInteracted(FInteractionHandle Handle, UPlayerInteractionComponent* Player);
+
+	void OnLightweightUsed(FInteractionHandle Handle);
+
+	// Returns the instance index of Handle if it belongs to InstancedMesh
+	int32 FindInstanceIndex(const FInteractionHandle& Handle) const;
+
+	void RemoveInstance(int32 InstanceIndex);
+
+public:
+
+	UInstancedInteractableComponent();
+
+	// Options shared by every instance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	UInteractableDefinition* Definition = nullptr;
+
+	// Mesh whose instances are interactable, the first instanced static mesh of the owner if not set
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	UInstancedStaticMeshComponent* InstancedMesh = nullptr;
+
+	// If true instances used up by bDisableAfterUsage are removed from the mesh instead of hidden
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	bool bRemoveInstanceAfterUsage = false;
+
+	UPROPERTY(BlueprintAssignable, Category = "InteractionDelegates")
+	FInstancedInteractableDelegate OnInstanceInteractedDelegate;
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void RefreshInstances();
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void SetInstanceEnabled(int32 InstanceIndex, bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	bool IsInstanceUsable(int32 InstanceIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	FInteractionHandle GetInstanceHandle(int32 InstanceIndex) const;
+
+	// Instances themselves are lightweight interactables and counted with the subsystem caches
+	void AddMemoryUsage(FInteractionMemoryReport& Report) const;
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+};
@@ -0,0 +1,95 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SphereComponent.h"
+
+#include "InteractableClusterComponent.generated.h"
+
+class UInteractableComponent;
+class UPlayerInteractionComponent;
+struct FInteractionMemoryReport;
+
+/*Groups interactables placed close together (shelves, racks, loot piles) under one bounding sphere. Members
+don't use their own overlap spheres, players overlapping the cluster get members in reach added on a timer and
+every member shares one reachability trace per player and frame. Angle and look-at checks stay per member.
+Members are the interactables of the owner and of actors attached to it unless added manually.*/
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent), Blueprintable)
+class INTERACTIONSYSTEM_API UInteractableClusterComponent : public USphereComponent
+{
+	GENERATED_BODY()
+
+private:
+
+	struct FClusterReachability
+	{
+		TWeakObjectPtr<const AActor> Player;
+
+		uint64 Frame = 0;
+
+		bool bReachable = false;
+	};
+
+	TArray<TWeakObjectPtr<UInteractableComponent>> Members;
+
+	TArray<TWeakObjectPtr<UPlayerInteractionComponent>> PlayersInRange;
+
+	mutable TArray<FClusterReachability, TInlineAllocator<2>> ReachabilityCache;
+
+	FTimerHandle MemberUpdateTimerHandle;
+
+	void GatherMembers();
+
+	void FitToMembers();
+
+	// Adds members in reach of Player and removes the others
+	void UpdatePlayer(UPlayerInteractionComponent* Player);
+
+	void UpdateMembers();
+
+	UFUNCTION()
+	void OnClusterOverlapBegin(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnClusterOverlapEnd(UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex);
+
+public:
+
+	UInteractableClusterComponent();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	bool bGatherMembersOnBeginPlay = true;
+
+	// Grows the sphere on BeginPlay so it contains the reach of every member
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
+	bool bFitToMembers = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.01"), Category = "Interaction")
+	float MemberUpdateInterval = 0.1f;
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void AddMember(UInteractableComponent* Member);
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void RemoveMember(UInteractableComponent* Member);
+
+	// Representative trace from the cluster centre, cached per player for the current frame
+	bool IsReachableBy(const AActor* Player) const;
+
+	int32 GetNumMembers() const
+	{
+		return Members.Num();
+	}
+
+	void AddMemoryUsage(FInteractionMemoryReport& Report) const;
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+};
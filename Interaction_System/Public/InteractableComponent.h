@@ -6,19 +6,20 @@
 #include "Components/SceneComponent.h"
 
 #include "InteractionInterface.h"
+#include "InteractionEvaluation.h"
+#include "InteractionEvents.h"
 #include "PlayerInteractionComponent.h"
 
 #include "InteractableComponent.generated.h"
 
 class UWidgetComponent;
 class USphereComponent;
+class UInteractableClusterComponent;
+class UInteractableDefinition;
+struct FInteractionMemoryReport;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDynamicMulticastDelegateOP_P, AActor*, Player);
 
-constexpr float PlayerLooksAtInteractableValue = 3.14f;
-constexpr float Multiplier = 180.f / PI;
-constexpr float FAILED_Angle = 400.f;
-
 USTRUCT(BlueprintType)
 struct FInteractable
 {
@@ -111,9 +112,26 @@ class INTERACTIONSYSTEM_API UInteractableComponent : public USceneComponent, pub
 
 private:
 
-	TArray<TWeakObjectPtr<UPlayerInteractionComponent>> PlayerComponents;
+	/*Subscribed players ordered by interaction index, players without one follow the indexed ones. Together with
+	SubscribedPlayerMask this is the whole subscription state.*/
+	TArray<TWeakObjectPtr<UPlayerInteractionComponent>, TInlineAllocator<4>> PlayerComponents;
+
+	// Bit per UPlayerInteractionComponent::GetInteractionIndex() of subscribed players
+	uint64 SubscribedPlayerMask = 0;
+
+	/*Slot of PlayerComponent in PlayerComponents or INDEX_NONE, O(1) for indexed players since their slot is the
+	number of lower bits set in SubscribedPlayerMask.*/
+	int32 FindSubscriberSlot(const UPlayerInteractionComponent* PlayerComponent) const;
+
+	// Local player whose debug string properties are used by DrawDebugStrings
+	TWeakObjectPtr<UPlayerInteractionComponent> DebugPropertiesSource;
 
-	FTimerHandle InteractionTimerHandle;
+	// Cluster doing discovery and reachability for this interactable
+	TWeakObjectPtr<UInteractableClusterComponent> Cluster;
+
+	FInteractionEvaluation LastEvaluation;
+
+	FDelegateHandle TransformUpdatedHandle;
 
 	FRotator WidgetRotation;
 
@@ -149,8 +167,6 @@ public:
 
 	TSubclassOf<UInteractionWidgetOnInteractable> InteractionWidgetOnInteractableClass;
 
-	FDebugStringProperties InstancedDSP;
-
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "!RandomizeRarityValue"),
 		Category = "Interaction")
 	int32 RarityValue;
@@ -166,14 +182,32 @@ public:
 		Category = "Interaction")
 	int32 RarityRandomizedMAX = 255;
 
-	UPROPERTY(BlueprintReadWrite, Category = "Interaction")
-	TArray<AActor*> SubscribedPlayers;
+	/*Shared configuration, interactables referencing the same definition share its options and only keep
+	bDisabled and Priority per instance.*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Interaction")
+	UInteractableDefinition* Definition = nullptr;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Interaction")
-	FInteractable InteractableStructure;
+	/*Options of this interactable alone, used without a shared Definition and only allocated by the interactables
+	that need one. Options are configuration and aren't replicated, only the per-instance state below is.*/
+	UPROPERTY(EditAnywhere, Instanced, BlueprintReadOnly, meta = (EditCondition = "Definition == nullptr"),
+		Category = "Interaction")
+	UInteractableDefinition* InlineDefinition = nullptr;
 
-	UPROPERTY(BlueprintReadWrite, Category = "Interaction")
-	int32 AmountOfSubscribedPlayers = 0;
+	// Disabled even if the options enable it, changed at runtime by Enable and Disable
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Replicated, Category = "Interaction")
+	bool bDisabled = false;
+
+	// Initialized from the options in BeginPlay, changed at runtime by SetPriority
+	UPROPERTY(BlueprintReadOnly, ReplicatedUsing = OnRep_Priority, Category = "Interaction")
+	int32 Priority = 0;
+
+#if WITH_EDITORONLY_DATA
+
+	// Options saved inline before definitions existed, moved into InlineDefinition on load
+	UPROPERTY()
+	FInteractable InteractableStructure_DEPRECATED;
+
+#endif //WITH_EDITORONLY_DATA
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction")
 	bool bUseRotationVariablesFromPlayerComponent = true;
@@ -188,6 +222,15 @@ public:
 
 	bool CanShowInteractionMarker;
 
+	// Index inside the interaction subsystem spatial grid, only registered on the server
+	int32 SpatialGridIndex = INDEX_NONE;
+
+	// SpatialGridIndex points into the dynamic tier of moving interactables
+	bool bInDynamicSpatialGrid = false;
+
+	// Queued in the subsystem for a grid update this frame
+	bool bSpatialGridDirty = false;
+
 #pragma region Delegates
 
 public:
@@ -216,6 +259,15 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FDynamicMulticastDelegate OnInteractionMarkerUsable;
 
+	// Native variants, broadcasted right before their dynamic delegate by the subsystem's event queue
+	FInteractionNativeDelegate OnCanInteract;
+
+	FInteractionNativeDelegate OnSubscribed;
+
+	FInteractionNativeDelegate OnSelected;
+
+	FInteractionNativeDelegate OnUnsubscribed;
+
 #pragma endregion
 
 #pragma region Interaction Interface
@@ -235,15 +287,56 @@ public:
 	virtual void UnsubscribeFromComponent(AActor* Player) override;
 
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
-	virtual uint8 GetPriority() const override
+	virtual int32 GetPriority() const override
 	{
-		return InteractableStructure.Priority;
+		return Priority;
 	}
 
+	// Changes the priority and reorders it in every subscribed player's candidates
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void SetPriority(int32 NewPriority);
+
+private:
+
+	// Reorders the interactable in every subscribed player's candidates
+	void OnPriorityChanged();
+
+	// Replicated priorities reorder the client's candidates the same way SetPriority does
+	UFUNCTION()
+	void OnRep_Priority();
+
 #pragma endregion
 
 public:
 
+	// Options of this interactable, from the shared or the inline definition, defaults without either
+	const FInteractable& GetSettings() const;
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	FInteractable GetInteractableSettings() const
+	{
+		return GetSettings();
+	}
+
+	// Owners of the subscribed players, built from the subscription state on every call
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	TArray<AActor*> GetSubscribedPlayers() const;
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	int32 GetAmountOfSubscribedPlayers() const
+	{
+		return PlayerComponents.Num();
+	}
+
+	void SetDebugPropertiesSource(UPlayerInteractionComponent* PlayerComponent);
+
+	const FDebugStringProperties& GetDebugStringProperties() const;
+
+	const FInteractionEvaluation& GetLastEvaluation() const
+	{
+		return LastEvaluation;
+	}
+
 	UFUNCTION(BlueprintCallable, Category = "NameWidget")
 	void ShowInteractableName(UNameWidget* Widget);
 
@@ -294,30 +387,74 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
 	bool IsSubscribed(const UPlayerInteractionComponent* PlayerComponent) const;
 
+	// Called by the cluster, disables this interactable's own overlap discovery
+	void JoinCluster(UInteractableClusterComponent* NewCluster);
+
+	void LeaveCluster();
+
+	UInteractableClusterComponent* GetCluster() const
+	{
+		return Cluster.Get();
+	}
+
+	/*Fills OutJob with the state CanInteract checks against View, called on the game thread. Clusters and players
+	without a subscription are resolved here, the rest by FInteractionEvaluationJob::Evaluate on any thread.*/
+	void GatherEvaluation(const FInteractionEvaluationView& View, int32 ViewIndex, bool bAlwaysCheckReachability,
+		FInteractionEvaluationJob& OutJob) const;
+
+	// Stores the results of an evaluated job as LastEvaluation, called on the game thread
+	void ApplyEvaluation(const FInteractionEvaluationJob& Job, const FInteractionEvaluationView& View);
+
+	bool CheckReachability(const AActor* SubscribedPlayer) const;
+
+	// Same checks as CanInteract but evaluated from a recorded player state instead of the current one
+	bool CanInteractFromSnapshot(const UPlayerInteractionComponent* PlayerComponent,
+		const FInteractionPlayerSnapshot& Snapshot) const;
+
+	/*Picks the randomized priority and rarity, from a stream seeded per interactable while the interaction
+	subsystem has a random seed so recordings and their replays get the same values.*/
+	void RandomizeValues();
+
+	// Adds this interactable, its widget and sphere components and its subscriptions to Report
+	void AddMemoryUsage(FInteractionMemoryReport& Report) const;
+
 private:
 
 	UInteractableComponent();
 
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
 
-	void BroadcastCanInteract(const UPlayerInteractionComponent* PlayerComponent) const;
+	void BroadcastCanInteract(UPlayerInteractionComponent* PlayerComponent);
 
 	void RotateWidgetsToPlayer(bool ToCamera);
 
 	void DrawDebugStrings(const AActor* Player) const;
 
-	bool CheckReachability(const AActor* SubscribedPlayer) const;
+	bool CheckReachabilityFromLocation(const AActor* Player, const FVector& PlayerLocation) const;
 
-	float CheckDistanceToPlayer(const AActor* SubscribedPlayer) const;
+	void DrawReachabilityDebugLine(const FVector& PlayerLocation) const;
 
-	float CheckAngleToPlayer(const AActor* SubscribedPlayer) const;
+	float CheckAngleFromSnapshot(const UPlayerInteractionComponent* PlayerComponent,
+		const FInteractionPlayerSnapshot& Snapshot) const;
 
 	void TryHideWidgets(UPlayerInteractionComponent* PlayerComponent);
 
+	// Publishes the new location to the subsystem instead of it polling every interactable
+	void OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags,
+		ETeleportType Teleport);
+
 protected:
 
+	virtual void PostLoad() override;
+
+	virtual void OnRegister() override;
+
+	virtual void OnUnregister() override;
+
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 };
@@ -0,0 +1,23 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+
+#include "InteractableComponent.h"
+
+#include "InteractableDefinition.generated.h"
+
+/*Interactable configuration shared by every component referencing it. Components using a definition only keep
+bDisabled and the possibly randomized Priority per instance.*/
+UCLASS(BlueprintType, EditInlineNew)
+class INTERACTIONSYSTEM_API UInteractableDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interactable Option")
+	FInteractable Settings;
+};
@@ -0,0 +1,78 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "InteractionBenchmarkCommandlet.generated.h"
+
+class UWorld;
+
+// Results of one interactable count
+struct FInteractionBenchmarkResult
+{
+	int32 Interactables = 0;
+
+	int32 Pawns = 0;
+
+	int32 Frames = 0;
+
+	// Task graph workers available to the parallel evaluation
+	int32 Workers = 0;
+
+	bool bParallel = false;
+
+	float SpawnMs = 0.f;
+
+	float MeanPluginMs = 0.f;
+
+	float P99PluginMs = 0.f;
+
+	float MaxPluginMs = 0.f;
+
+	float MeanFrameMs = 0.f;
+
+	float P99FrameMs = 0.f;
+
+	float TracesPerFrame = 0.f;
+
+	uint32 CreatedWidgets = 0;
+
+	uint32 Interactions = 0;
+
+	int64 PluginObjectBytes = 0;
+
+	int64 UsedPhysicalDeltaBytes = 0;
+};
+
+/*Headless scalability benchmark, spawns interactables with mixed settings in a standalone world and moves
+scripted pawns along a fixed path through them. Reports game thread time spent inside the plugin, traces,
+created widgets and memory per interactable count.
+
+<Editor>-Cmd <Project> -run=InteractionBenchmark -nullrhi -unattended
+
+Optional: -Counts=1000,10000,50000 -Pawns=1 -Frames=600 -Spacing=150 -Seed=7 -Output=<Path without extension>
+-Parallel=0|1 overrides Interaction.ParallelEvaluation, the number of workers follows the machine (or -corelimit=).
+Results are written as CSV and JSON to Saved/Profiling/InteractionBench unless -Output is given.*/
+UCLASS()
+class INTERACTIONSYSTEM_API UInteractionBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+private:
+
+	FInteractionBenchmarkResult RunBenchmark(int32 NumInteractables, int32 NumPawns, int32 NumFrames,
+		float Spacing, int32 Seed) const;
+
+	void SpawnInteractables(UWorld* World, int32 NumInteractables, float Spacing, int32 Seed) const;
+
+	void WriteResults(const TArray<FInteractionBenchmarkResult>& Results, const FString& OutputPath) const;
+
+public:
+
+	UInteractionBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+};
@@ -0,0 +1,148 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class AActor;
+class UWorld;
+class UInteractableComponent;
+
+constexpr float PlayerLooksAtInteractableValue = 3.14f;
+constexpr float Multiplier = 180.f / PI;
+constexpr float FAILED_Angle = 400.f;
+
+enum class EInteractionEvaluationResult : uint8
+{
+	NotEvaluated,
+	Usable,
+	Disabled,
+	TooFar,
+	Unreachable,
+	WrongAngle
+};
+
+/*Results of the last CanInteract call, drawn by the debug overlay and the debug strings instead of evaluating
+the interactable again. Checks skipped because an earlier one failed are left unset.*/
+struct FInteractionEvaluation
+{
+	TObjectKey<AActor> Player;
+
+	EInteractionEvaluationResult Result = EInteractionEvaluationResult::NotEvaluated;
+
+	// Negative if the distance was not checked
+	float Distance = -1.f;
+
+	float Angle = FAILED_Angle;
+
+	bool bReachabilityChecked = false;
+
+	bool bReachable = false;
+
+	bool bAngleChecked = false;
+};
+
+/*State of one player read on the game thread before its candidates are evaluated, see
+UPlayerInteractionComponent::GatherEvaluationView. Evaluating against it touches no UObject of the player.*/
+struct FInteractionEvaluationView
+{
+	const AActor* Player = nullptr;
+
+	FVector PawnLocation = FVector::ZeroVector;
+
+	// Location and direction the selection scores are measured from
+	FVector SelectionLocation = FVector::ZeroVector;
+
+	FVector SelectionDirection = FVector::ForwardVector;
+
+	// Forward vector of the player's arrow, used by the third person angle
+	FVector ArrowForward = FVector::ForwardVector;
+
+	// Hit by the camera of the first local player, traced once per view instead of once per candidate
+	const AActor* LookedAtActor = nullptr;
+
+	// Projection of the first local player, used by the first person angle
+	FMatrix ViewProjectionMatrix = FMatrix::Identity;
+
+	FIntRect ViewRect;
+
+	// Normalized like the projected interactable location before the angle between them is measured
+	FVector2D ScreenCenter = FVector2D::ZeroVector;
+
+	// Logged on the game thread for every candidate whose angle couldn't be measured
+	const TCHAR* AngleFailure = nullptr;
+
+	bool bHasPlayerComponent = false;
+
+	bool bFirstPerson = false;
+
+	bool bHasToLookAt = false;
+
+	bool bHasViewport = false;
+};
+
+/*One interactable evaluated for one player. Gathered and applied on the game thread, Evaluate only reads the
+job, its view and the collision scene so jobs can be evaluated on any thread.*/
+struct INTERACTIONSYSTEM_API FInteractionEvaluationJob
+{
+	// Inputs, filled by UInteractableComponent::GatherEvaluation
+
+	const UInteractableComponent* Interactable = nullptr;
+
+	const AActor* InteractableOwner = nullptr;
+
+	// Index of the view in the batch being evaluated
+	int32 ViewIndex = INDEX_NONE;
+
+	FVector Location = FVector::ZeroVector;
+
+	float MaximumDistance = 0.f;
+
+	float AngleMargin = 0.f;
+
+	bool bDisabled = false;
+
+	// The distance and the reachability are only measured for players with a subscription
+	bool bSubscribed = false;
+
+	bool bDistanceMatters = false;
+
+	bool bHasToBeReachable = false;
+
+	bool bAngleMatters = false;
+
+	// Reachability is resolved even if the interactable doesn't require it, the interaction marker uses it
+	bool bAlwaysCheckReachability = false;
+
+	// Set when the reachability is known before evaluating, players without a subscription or clusters
+	bool bReachabilityResolved = false;
+
+	bool bReachable = false;
+
+	// True if the reachability was traced by this job instead of being resolved during the gather
+	bool bReachabilityTraced = false;
+
+	// Outputs, filled by Evaluate
+
+	FInteractionEvaluation Evaluation;
+
+	// Only set if the candidate is usable
+	float SelectionDistance = 0.f;
+
+	float SelectionViewDot = 0.f;
+
+	void Evaluate(const UWorld* World, const FInteractionEvaluationView& View);
+
+	// Traces the reachability unless the gather resolved it, also used alone by CheckReachability
+	void ResolveReachability(const UWorld* World, const FInteractionEvaluationView& View);
+
+	// First person angle between the screen center and Location projected by the view, in degrees
+	static float MeasureScreenAngle(const FVector& Location, const FInteractionEvaluationView& View);
+
+private:
+
+	bool TraceReachability(const UWorld* World, const FInteractionEvaluationView& View) const;
+
+	float MeasureAngle(const FInteractionEvaluationView& View) const;
+};
@@ -0,0 +1,109 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UInteractableComponent;
+class UPlayerInteractionComponent;
+
+// Native variants of the interaction delegates, C++ listeners skip the reflection based dynamic dispatch
+DECLARE_MULTICAST_DELEGATE_TwoParams(FInteractionNativeDelegate, UInteractableComponent*,
+	UPlayerInteractionComponent*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FInteractionPlayerNativeDelegate, UPlayerInteractionComponent*);
+
+enum class EInteractionEvent : uint8
+{
+	// Delegates of UInteractableComponent
+	Subscribed,
+	Unsubscribed,
+	Selected,
+
+	// OnCanInteract of the interactable and of the player
+	CanInteract,
+
+	// Delegates of UPlayerInteractionComponent
+	InteractableSubscribed,
+	InteractableUnsubscribed,
+	FirstInteractableSubscribed,
+	NoInteractablesLeft,
+	InteractableSelected
+};
+
+struct FInteractionEvent
+{
+	TWeakObjectPtr<UInteractableComponent> Interactable;
+
+	TWeakObjectPtr<UPlayerInteractionComponent> Player;
+
+	EInteractionEvent Type = EInteractionEvent::Subscribed;
+
+	// Coalesced with a later event, skipped by the flush
+	bool bCancelled = false;
+};
+
+/*Interaction events raised during a frame, broadcasted in order by UInteractionSubsystem once per frame.
+Redundant events are coalesced while queued: a subscription and an unsubscription of the same pair (or the first
+interactable and no interactables left of the same player) cancel each other, repeated events of a pair are
+broadcasted once and only the last selection of a player is broadcasted. An unsubscription also drops the
+pending selection and can interact events of its pair.*/
+class INTERACTIONSYSTEM_API FInteractionEventQueue
+{
+	struct FKey
+	{
+		const UInteractableComponent* Interactable = nullptr;
+
+		const UPlayerInteractionComponent* Player = nullptr;
+
+		// Events of one channel coalesce with each other
+		uint8 Channel = 0;
+
+		bool operator==(const FKey& Other) const
+		{
+			return Interactable == Other.Interactable && Player == Other.Player && Channel == Other.Channel;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(PointerHash(Key.Interactable, PointerHash(Key.Player)), Key.Channel);
+		}
+	};
+
+	TArray<FInteractionEvent> Events;
+
+	// Swapped with Events while they are broadcasted, listeners may queue more events
+	TArray<FInteractionEvent> FlushingEvents;
+
+	// Index of the latest queued event of every key
+	TMap<FKey, int32> LatestEvents;
+
+	static FKey MakeKey(EInteractionEvent Type, const UInteractableComponent* Interactable,
+		const UPlayerInteractionComponent* Player);
+
+	// Cancels the pending Selected, CanInteract and InteractableSelected events of an unsubscribed pair
+	void CancelPairEvents(const UInteractableComponent* Interactable, const UPlayerInteractionComponent* Player);
+
+public:
+
+	void Add(EInteractionEvent Type, UInteractableComponent* Interactable, UPlayerInteractionComponent* Player);
+
+	/*Broadcasts every queued event. Events queued by the listeners are broadcasted by the same flush, after a few
+	passes the rest waits for the next frame.*/
+	void Flush();
+
+	void Reset();
+
+	int32 Num() const
+	{
+		return Events.Num();
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Events.GetAllocatedSize() + FlushingEvents.GetAllocatedSize() + LatestEvents.GetAllocatedSize();
+	}
+
+	// Calls the native and the dynamic delegates of Event
+	static void Dispatch(const FInteractionEvent& Event);
+};
@@ -0,0 +1,101 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Player state captured on the server, used to evaluate interactions from the client's point of view.
+struct FInteractionPlayerSnapshot
+{
+	float TimeStamp = 0.f;
+
+	FVector PawnLocation = FVector::ZeroVector;
+
+	// Forward vector of the arrow used by the angle evaluation in third person mode
+	FVector ForwardVector = FVector::ForwardVector;
+
+	FVector ViewLocation = FVector::ZeroVector;
+
+	FRotator ViewRotation = FRotator::ZeroRotator;
+};
+
+/*Fixed-size ring buffer of player snapshots. Storage is inline, recording never allocates and the memory
+per player is always Capacity * sizeof(FInteractionPlayerSnapshot).*/
+template<int32 Capacity>
+class TInteractionHistoryBuffer
+{
+	static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "History capacity has to be a power of two.");
+
+private:
+
+	FInteractionPlayerSnapshot Samples[Capacity];
+
+	int32 Head = 0;
+
+	int32 Count = 0;
+
+	const FInteractionPlayerSnapshot& GetFromNewest(int32 Offset) const
+	{
+		return Samples[(Head - 1 - Offset) & (Capacity - 1)];
+	}
+
+public:
+
+	void Record(const FInteractionPlayerSnapshot& Snapshot)
+	{
+		Samples[Head] = Snapshot;
+		Head = (Head + 1) & (Capacity - 1);
+		Count = FMath::Min(Count + 1, Capacity);
+	}
+
+	void Reset()
+	{
+		Head = 0;
+		Count = 0;
+	}
+
+	int32 Num() const
+	{
+		return Count;
+	}
+
+	// Returns the state at TimeStamp interpolated between the two closest samples, clamped to the recorded range.
+	bool Sample(float TimeStamp, FInteractionPlayerSnapshot& OutSnapshot) const
+	{
+		if (!Count)
+		{
+			return false;
+		}
+
+		const FInteractionPlayerSnapshot& Newest = GetFromNewest(0);
+
+		if (TimeStamp >= Newest.TimeStamp)
+		{
+			OutSnapshot = Newest;
+			return true;
+		}
+
+		for (int32 Offset = 1; Offset < Count; ++Offset)
+		{
+			const FInteractionPlayerSnapshot& Older = GetFromNewest(Offset);
+
+			if (Older.TimeStamp <= TimeStamp)
+			{
+				const FInteractionPlayerSnapshot& Newer = GetFromNewest(Offset - 1);
+				const float Span = Newer.TimeStamp - Older.TimeStamp;
+				const float Alpha = Span > KINDA_SMALL_NUMBER ? (TimeStamp - Older.TimeStamp) / Span : 1.f;
+
+				OutSnapshot.TimeStamp = TimeStamp;
+				OutSnapshot.PawnLocation = FMath::Lerp(Older.PawnLocation, Newer.PawnLocation, Alpha);
+				OutSnapshot.ForwardVector = FMath::Lerp(Older.ForwardVector, Newer.ForwardVector, Alpha).GetSafeNormal();
+				OutSnapshot.ViewLocation = FMath::Lerp(Older.ViewLocation, Newer.ViewLocation, Alpha);
+				OutSnapshot.ViewRotation = FQuat::Slerp(Older.ViewRotation.Quaternion(),
+					Newer.ViewRotation.Quaternion(), Alpha).Rotator();
+				return true;
+			}
+		}
+
+		OutSnapshot = GetFromNewest(Count - 1);
+		return true;
+	}
+};
@@ -0,0 +1,86 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "InteractionLatency.generated.h"
+
+// Stages of an interaction from the input to the result arriving back on the client
+UENUM(BlueprintType)
+enum class EInteractionLatencyStage : uint8
+{
+	/*Start of the frame the input was pumped in to the request being sent, or to the interaction being executed
+	when playing offline. Covers the game thread work between the input event and the interaction call.*/
+	Input,
+
+	// Time a completed hold took longer than TimeInSecondsForButtonHold
+	Hold,
+
+	// Request received by the server to being processed by the interaction subsystem
+	Queue,
+
+	// ExecuteInteract including the Interact handlers
+	Execute,
+
+	// Round trip measured on the client minus the time the request spent on the server
+	Network,
+
+	// Input to the confirmation received on the client, the hold duration is excluded
+	Total,
+
+	MAX UMETA(Hidden)
+};
+
+/*Latency histogram with 0.5 ms buckets up to 50 ms, 5 ms buckets up to 1 s and one overflow bucket.
+Percentiles are reported as the upper bound of the bucket they fall into.*/
+struct INTERACTIONSYSTEM_API FInteractionLatencyHistogram
+{
+private:
+
+	static constexpr int32 NumFineBuckets = 100;
+
+	static constexpr int32 NumCoarseBuckets = 190;
+
+	static constexpr int32 NumBuckets = NumFineBuckets + NumCoarseBuckets + 1;
+
+	static constexpr float FineBucketMs = 0.5f;
+
+	static constexpr float CoarseBucketMs = 5.f;
+
+	uint32 Buckets[NumBuckets] = {};
+
+	uint32 Count = 0;
+
+	double SumMs = 0.0;
+
+	float MaxMs = 0.f;
+
+	static int32 GetBucket(float Milliseconds);
+
+	static float GetBucketUpperBound(int32 Bucket);
+
+public:
+
+	void Add(float Milliseconds);
+
+	void Reset();
+
+	// Fraction in [0, 1], returns 0 when there are no samples
+	float GetPercentile(float Fraction) const;
+
+	uint32 Num() const
+	{
+		return Count;
+	}
+
+	float GetMean() const
+	{
+		return Count ? static_cast<float>(SumMs / Count) : 0.f;
+	}
+
+	float GetMax() const
+	{
+		return MaxMs;
+	}
+};
@@ -0,0 +1,224 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "InteractionLightweight.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/*Handle of a lightweight interactable owned by UInteractionSubsystem. The serial detects handles of removed
+interactables whose slot was reused. Handles are local to each machine, instances are sent over the network as
+their mesh and instance index instead. Handles of lightweight interactables without an instance match between
+server and clients only when every machine adds the same interactables in the same order, e.g. from level data.*/
+USTRUCT(BlueprintType)
+struct FInteractionHandle
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 Index = INDEX_NONE;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 Serial = 0;
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	void Reset()
+	{
+		Index = INDEX_NONE;
+		Serial = 0;
+	}
+
+	bool operator==(const FInteractionHandle& Other) const
+	{
+		return Index == Other.Index && Serial == Other.Serial;
+	}
+
+	bool operator!=(const FInteractionHandle& Other) const
+	{
+		return !(*this == Other);
+	}
+
+	friend uint32 GetTypeHash(const FInteractionHandle& Handle)
+	{
+		return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Serial));
+	}
+};
+
+namespace EInteractionLightweightFlags
+{
+	enum Type : uint8
+	{
+		None = 0,
+
+		// Not usable until enabled again
+		Disabled = 1 << 0,
+
+		// Used with bDisableAfterUsage
+		Used = 1 << 1,
+
+		// Backing instance is hidden
+		Hidden = 1 << 2
+	};
+}
+
+/*Interactables without an actor or component, stored as parallel arrays. Slots of removed interactables
+are reused, their serial is incremented so old handles stop resolving.*/
+class FInteractionLightweightStore
+{
+private:
+
+	TArray<FVector> Locations;
+
+	TArray<int32> DefinitionIndices;
+
+	TArray<uint8> Flags;
+
+	TArray<int32> Serials;
+
+	TArray<int32> GridIndices;
+
+	TArray<TWeakObjectPtr<UInstancedStaticMeshComponent>> InstanceComponents;
+
+	TArray<int32> InstanceIndices;
+
+	TArray<int32> FreeIndices;
+
+	int32 NumAlive = 0;
+
+public:
+
+	FInteractionHandle Add(const FVector& Location, int32 DefinitionIndex,
+		UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex)
+	{
+		int32 Index;
+
+		if (FreeIndices.Num())
+		{
+			Index = FreeIndices.Pop(false);
+		}
+		else
+		{
+			Index = Locations.AddUninitialized();
+			DefinitionIndices.AddUninitialized();
+			Flags.AddUninitialized();
+			Serials.Add(0);
+			GridIndices.AddUninitialized();
+			InstanceComponents.AddDefaulted();
+			InstanceIndices.AddUninitialized();
+		}
+
+		Locations[Index] = Location;
+		DefinitionIndices[Index] = DefinitionIndex;
+		Flags[Index] = EInteractionLightweightFlags::None;
+		GridIndices[Index] = INDEX_NONE;
+		InstanceComponents[Index] = InstanceComponent;
+		InstanceIndices[Index] = InstanceIndex;
+
+		++NumAlive;
+
+		FInteractionHandle Handle;
+		Handle.Index = Index;
+		Handle.Serial = Serials[Index];
+
+		return Handle;
+	}
+
+	void Remove(const FInteractionHandle& Handle)
+	{
+		if (!IsValid(Handle))
+		{
+			return;
+		}
+
+		++Serials[Handle.Index];
+		DefinitionIndices[Handle.Index] = INDEX_NONE;
+		InstanceComponents[Handle.Index] = nullptr;
+		FreeIndices.Add(Handle.Index);
+
+		--NumAlive;
+	}
+
+	bool IsValid(const FInteractionHandle& Handle) const
+	{
+		return Serials.IsValidIndex(Handle.Index) && Serials[Handle.Index] == Handle.Serial
+			&& DefinitionIndices[Handle.Index] != INDEX_NONE;
+	}
+
+	const FVector& GetLocation(const FInteractionHandle& Handle) const
+	{
+		return Locations[Handle.Index];
+	}
+
+	int32 GetDefinitionIndex(const FInteractionHandle& Handle) const
+	{
+		return DefinitionIndices[Handle.Index];
+	}
+
+	uint8 GetFlags(const FInteractionHandle& Handle) const
+	{
+		return Flags[Handle.Index];
+	}
+
+	void SetFlags(const FInteractionHandle& Handle, uint8 NewFlags)
+	{
+		Flags[Handle.Index] = NewFlags;
+	}
+
+	int32 GetGridIndex(const FInteractionHandle& Handle) const
+	{
+		return GridIndices[Handle.Index];
+	}
+
+	void SetGridIndex(const FInteractionHandle& Handle, int32 GridIndex)
+	{
+		GridIndices[Handle.Index] = GridIndex;
+	}
+
+	UInstancedStaticMeshComponent* GetInstanceComponent(const FInteractionHandle& Handle) const
+	{
+		return InstanceComponents[Handle.Index].Get();
+	}
+
+	int32 GetInstanceIndex(const FInteractionHandle& Handle) const
+	{
+		return InstanceIndices[Handle.Index];
+	}
+
+	void SetInstanceIndex(const FInteractionHandle& Handle, int32 InstanceIndex)
+	{
+		InstanceIndices[Handle.Index] = InstanceIndex;
+	}
+
+	int32 Num() const
+	{
+		return NumAlive;
+	}
+
+	void Empty()
+	{
+		Locations.Empty();
+		DefinitionIndices.Empty();
+		Flags.Empty();
+		Serials.Empty();
+		GridIndices.Empty();
+		InstanceComponents.Empty();
+		InstanceIndices.Empty();
+		FreeIndices.Empty();
+		NumAlive = 0;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Locations.GetAllocatedSize() + DefinitionIndices.GetAllocatedSize() + Flags.GetAllocatedSize()
+			+ Serials.GetAllocatedSize() + GridIndices.GetAllocatedSize() + InstanceComponents.GetAllocatedSize()
+			+ InstanceIndices.GetAllocatedSize() + FreeIndices.GetAllocatedSize();
+	}
+};
@@ -0,0 +1,73 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+class UUserWidget;
+
+/*Low level memory tracker tags, allocations made inside INTERACTION_LLM_SCOPE show up under Interaction in
+stat LLMFULL and in -LLMCSV captures instead of the generic engine buckets.*/
+LLM_DECLARE_TAG_API(Interaction, INTERACTIONSYSTEM_API);
+LLM_DECLARE_TAG_API(Interaction_Components, INTERACTIONSYSTEM_API);
+LLM_DECLARE_TAG_API(Interaction_Widgets, INTERACTIONSYSTEM_API);
+LLM_DECLARE_TAG_API(Interaction_Subscriptions, INTERACTIONSYSTEM_API);
+LLM_DECLARE_TAG_API(Interaction_Caches, INTERACTIONSYSTEM_API);
+
+// Category is one of Components, Widgets, Subscriptions or Caches
+#define INTERACTION_LLM_SCOPE(Category) LLM_SCOPE_BYTAG(Interaction_##Category)
+
+struct FInteractionMemoryCategory
+{
+	int32 Count = 0;
+
+	SIZE_T Bytes = 0;
+
+	void Add(int32 InCount, SIZE_T InBytes)
+	{
+		Count += InCount;
+		Bytes += InBytes;
+	}
+};
+
+/*Memory owned by the interaction system in one world, filled by the AddMemoryUsage functions of the
+plugin's classes. Object sizes are the UObject instances plus their heap containers, Slate and render
+resources behind widgets are not included.*/
+struct INTERACTIONSYSTEM_API FInteractionMemoryReport
+{
+	// Interaction components, clusters and the interaction subsystem
+	FInteractionMemoryCategory Components;
+
+	FInteractionMemoryCategory WidgetComponents;
+
+	FInteractionMemoryCategory SphereComponents;
+
+	// Subscribed players of interactables and candidates of players, Count is the number of pairs
+	FInteractionMemoryCategory Subscriptions;
+
+	// Spatial grids, registries, queues and other lookups, Count is the number of owners
+	FInteractionMemoryCategory Caches;
+
+	// Shadow copies of the replicated interactable settings the server keeps per client connection, estimated
+	FInteractionMemoryCategory ReplicatedState;
+
+	// Created widgets by class, each widget counted once together with its widget tree
+	TMap<FName, FInteractionMemoryCategory> Widgets;
+
+	// Adds Object to Category once, objects referenced by several owners are not counted twice
+	void AddObject(FInteractionMemoryCategory& Category, const UObject* Object);
+
+	void AddWidget(const UUserWidget* Widget);
+
+	SIZE_T GetTotalBytes() const;
+
+	void Log(FOutputDevice& Ar, const TCHAR* Title) const;
+
+	// Size of the instance and its resources, without the objects it references
+	static SIZE_T GetObjectBytes(const UObject* Object);
+
+private:
+
+	TSet<const UObject*> CountedObjects;
+};
@@ -0,0 +1,163 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/GameModeBase.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "InteractionNetBenchmark.generated.h"
+
+class UInteractableComponent;
+class UInteractableDefinition;
+class UPlayerInteractionComponent;
+
+/*Headless multi-client benchmark of the interaction system.
+
+Server:  <Project> <Map>?game=/Script/InteractionSystem.InteractionBenchmarkGameMode -server -nullrhi -InteractionNetBench
+Bots:    <Project> 127.0.0.1 -game -nullrhi -InteractionNetBench -InteractionBot -InteractionBotIndex=<N>
+
+Optional: -InteractionBenchCount=2000 -InteractionBenchSpacing=150 -InteractionBenchSeed=7
+-InteractionBenchDuration=60 -InteractionBenchExit
+Results are written by the server to Saved/Profiling/InteractionNetBench.
+The benchmark classes are hidden from class pickers and stay inert in Shipping builds.*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class INTERACTIONSYSTEM_API AInteractionBenchmarkActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+
+	AInteractionBenchmarkActor();
+
+	UPROPERTY(VisibleAnywhere, Category = "Interaction")
+	UInteractableComponent* Interactable;
+
+	// Index of the shared benchmark definition, replicated so clients share the same options without sending them
+	UPROPERTY(Replicated)
+	int32 SettingsVariant = 0;
+
+	static constexpr int32 NumSettingsVariants = 16;
+
+	// Definition shared by every benchmark actor using the variant, built from the variant as seed
+	static UInteractableDefinition* GetBenchmarkDefinition(int32 Variant);
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+};
+
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class INTERACTIONSYSTEM_API AInteractionBenchmarkPawn : public ACharacter
+{
+	GENERATED_BODY()
+
+public:
+
+	AInteractionBenchmarkPawn();
+
+	UPROPERTY(VisibleAnywhere, Category = "Interaction")
+	UPlayerInteractionComponent* PlayerInteraction;
+
+protected:
+
+	virtual void BeginPlay() override;
+};
+
+UCLASS(NotBlueprintable, NotPlaceable, Transient, HideDropdown)
+class INTERACTIONSYSTEM_API AInteractionBenchmarkGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+
+	AInteractionBenchmarkGameMode();
+};
+
+// Per connection totals sampled by the benchmark on the server
+struct FInteractionNetBenchConnection
+{
+	FString Name;
+
+	int64 InBytes = 0;
+
+	int64 OutBytes = 0;
+
+	uint32 ServerRPCs = 0;
+
+	uint32 ClientRPCs = 0;
+};
+
+UCLASS()
+class INTERACTIONSYSTEM_API UInteractionNetBenchmarkSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+private:
+
+	TArray<float> FrameTimesMs;
+
+	TArray<FInteractionNetBenchConnection> LastConnections;
+
+	FString CsvPath;
+
+	FRandomStream RandomStream;
+
+	int32 InteractableCount = 2000;
+
+	float Spacing = 150.f;
+
+	float Duration = 60.f;
+
+	float ElapsedTime = 0.f;
+
+	float NextReportTime = 1.f;
+
+	float NextBotInteractionTime = 0.f;
+
+	int32 BotIndex = 0;
+
+	bool bInitialized = false;
+
+	bool bStarted = false;
+
+	bool bFinished = false;
+
+	bool bIsBot = false;
+
+	bool bExitWhenFinished = false;
+
+	void StartServer();
+
+	void TickServer(float DeltaTime);
+
+	void TickBot(float DeltaTime);
+
+	void GatherConnections(TArray<FInteractionNetBenchConnection>& OutConnections) const;
+
+	void WriteReport(bool bFinal);
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual UWorld* GetTickableGameObjectWorld() const override
+	{
+		return GetWorld();
+	}
+};
@@ -0,0 +1,62 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Interaction functions of UPlayerInteractionComponent called by the game, replayed in the recorded order
+enum class EInteractionReplayInput : uint8
+{
+	Interact,
+
+	InteractOnServer,
+
+	StopInteraction
+};
+
+// State of one locally controlled player at the end of a recorded frame
+struct FInteractionReplayPlayer
+{
+	FVector Location = FVector::ZeroVector;
+
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	// Drives the camera used by the angle checks
+	FRotator ControlRotation = FRotator::ZeroRotator;
+
+	TArray<EInteractionReplayInput, TInlineAllocator<2>> Inputs;
+};
+
+struct FInteractionReplayFrame
+{
+	float DeltaTime = 0.f;
+
+	// Ordered like the players of the recording, see UInteractionSubsystem::GatherReplayPlayers
+	TArray<FInteractionReplayPlayer, TInlineAllocator<1>> Players;
+};
+
+/*Recorded interaction session. Stored as a compact binary file, locations are raw floats, rotations are
+quantized to 16 bits per axis and inputs take one byte each.*/
+struct INTERACTIONSYSTEM_API FInteractionReplay
+{
+	static constexpr uint32 Magic = 0x4C505249; // "IRPL"
+
+	static constexpr int32 Version = 1;
+
+	// Seed of every randomized interactable value while the recording was made
+	int32 RandomSeed = 0;
+
+	FString MapName;
+
+	TArray<FInteractionReplayFrame> Frames;
+
+	// Relative names are placed in Saved/Profiling/InteractionReplays
+	static FString GetReplayPath(const FString& Filename);
+
+	bool SaveToFile(const FString& Filename);
+
+	bool LoadFromFile(const FString& Filename);
+
+	// Reads or writes the replay depending on Ar
+	void Serialize(FArchive& Ar);
+};
@@ -0,0 +1,191 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*Uniform grid on the XY plane used to find interactables around players without overlap spheres.
+Every element has its own radius, a query returns elements whose radius reaches the queried sphere.
+Element indices are stable until the element is removed.*/
+template<typename PayloadType>
+class TInteractionSpatialGrid
+{
+private:
+
+	struct FElement
+	{
+		FVector Location;
+
+		float Radius;
+
+		FIntPoint Cell;
+
+		PayloadType Payload;
+	};
+
+	TSparseArray<FElement> Elements;
+
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	float CellSize;
+
+	float InvCellSize;
+
+	// Largest radius ever added, widens queries so elements reaching into neighbouring cells are found
+	float MaxRadius = 0.f;
+
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+	}
+
+	void AddToCell(int32 ElementIndex, const FIntPoint& Cell)
+	{
+		Cells.FindOrAdd(Cell).Add(ElementIndex);
+	}
+
+	void RemoveFromCell(int32 ElementIndex, const FIntPoint& Cell)
+	{
+		if (TArray<int32>* CellElements = Cells.Find(Cell))
+		{
+			CellElements->RemoveSingleSwap(ElementIndex, false);
+
+			if (!CellElements->Num())
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+
+public:
+
+	explicit TInteractionSpatialGrid(float InCellSize = 1000.f)
+		: CellSize(FMath::Max(InCellSize, 1.f)), InvCellSize(1.f / FMath::Max(InCellSize, 1.f))
+	{
+	}
+
+	int32 Add(const FVector& Location, float Radius, const PayloadType& Payload)
+	{
+		FElement Element;
+		Element.Location = Location;
+		Element.Radius = Radius;
+		Element.Cell = GetCell(Location);
+		Element.Payload = Payload;
+
+		const int32 ElementIndex = Elements.Add(Element);
+
+		AddToCell(ElementIndex, Element.Cell);
+		MaxRadius = FMath::Max(MaxRadius, Radius);
+
+		return ElementIndex;
+	}
+
+	// Avoids growing the element storage one by one when many elements are added at once
+	void Reserve(int32 NumElements)
+	{
+		Elements.Reserve(NumElements);
+	}
+
+	void Remove(int32 ElementIndex)
+	{
+		if (!Elements.IsValidIndex(ElementIndex))
+		{
+			return;
+		}
+
+		RemoveFromCell(ElementIndex, Elements[ElementIndex].Cell);
+		Elements.RemoveAt(ElementIndex);
+	}
+
+	void Update(int32 ElementIndex, const FVector& Location)
+	{
+		if (!Elements.IsValidIndex(ElementIndex))
+		{
+			return;
+		}
+
+		FElement& Element = Elements[ElementIndex];
+		Element.Location = Location;
+
+		const FIntPoint Cell = GetCell(Location);
+
+		if (Cell != Element.Cell)
+		{
+			RemoveFromCell(ElementIndex, Element.Cell);
+			AddToCell(ElementIndex, Cell);
+			Element.Cell = Cell;
+		}
+	}
+
+	bool IsValidIndex(int32 ElementIndex) const
+	{
+		return Elements.IsValidIndex(ElementIndex);
+	}
+
+	const PayloadType& GetPayload(int32 ElementIndex) const
+	{
+		return Elements[ElementIndex].Payload;
+	}
+
+	const FVector& GetLocation(int32 ElementIndex) const
+	{
+		return Elements[ElementIndex].Location;
+	}
+
+	int32 Num() const
+	{
+		return Elements.Num();
+	}
+
+	void Empty()
+	{
+		Elements.Empty();
+		Cells.Empty();
+		MaxRadius = 0.f;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T Bytes = Elements.GetAllocatedSize() + Cells.GetAllocatedSize();
+
+		for (const TPair<FIntPoint, TArray<int32>>& Cell : Cells)
+		{
+			Bytes += Cell.Value.GetAllocatedSize();
+		}
+
+		return Bytes;
+	}
+
+	// Calls Func(ElementIndex, Payload) for every element whose radius reaches the sphere at Location
+	template<typename FuncType>
+	void Query(const FVector& Location, float QueryRadius, FuncType&& Func) const
+	{
+		const float Reach = QueryRadius + MaxRadius;
+		const FIntPoint Min = GetCell(Location - FVector(Reach, Reach, 0.f));
+		const FIntPoint Max = GetCell(Location + FVector(Reach, Reach, 0.f));
+
+		for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+		{
+			for (int32 X = Min.X; X <= Max.X; ++X)
+			{
+				const TArray<int32>* CellElements = Cells.Find(FIntPoint(X, Y));
+
+				if (!CellElements)
+				{
+					continue;
+				}
+
+				for (const int32 ElementIndex : *CellElements)
+				{
+					const FElement& Element = Elements[ElementIndex];
+					const float Distance = QueryRadius + Element.Radius;
+
+					if (FVector::DistSquared(Location, Element.Location) <= Distance * Distance)
+					{
+						Func(ElementIndex, Element.Payload);
+					}
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,83 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Templates/Atomic.h"
+
+DECLARE_STATS_GROUP(TEXT("InteractionSystem"), STATGROUP_InteractionSystem, STATCAT_Advanced);
+
+// Counters shared by several files, defined in InteractionStats.cpp
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Line Traces"), STAT_InteractionTraces, STATGROUP_InteractionSystem, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("CreateWidget Calls"), STAT_InteractionCreateWidget, STATGROUP_InteractionSystem, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Subscribed Pairs"), STAT_InteractionSubscribedPairs, STATGROUP_InteractionSystem, INTERACTIONSYSTEM_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Candidates"), STAT_InteractionCandidates, STATGROUP_InteractionSystem, INTERACTIONSYSTEM_API);
+
+#if !UE_BUILD_SHIPPING
+
+/*Totals read by the benchmark commandlet, which has no stats thread to read the counters above from.
+Time is only collected while bEnabled is set, nested scopes count once.*/
+struct INTERACTIONSYSTEM_API FInteractionBenchmarkCounters
+{
+	static bool bEnabled;
+
+	static int32 ScopeDepth;
+
+	static uint64 Cycles;
+
+	// Incremented by the evaluation workers as well
+	static TAtomic<uint32> Traces;
+
+	static uint32 CreatedWidgets;
+
+	static void Reset()
+	{
+		Cycles = 0;
+		Traces = 0;
+		CreatedWidgets = 0;
+	}
+};
+
+// Measures game thread time spent inside the plugin, placed at its entry points (ticks, timers, overlaps)
+struct FInteractionBenchmarkScope
+{
+	uint64 StartCycles = 0;
+
+	bool bCounted;
+
+	FInteractionBenchmarkScope()
+		: bCounted(FInteractionBenchmarkCounters::bEnabled)
+	{
+		if (bCounted && FInteractionBenchmarkCounters::ScopeDepth++ == 0)
+		{
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	~FInteractionBenchmarkScope()
+	{
+		if (bCounted && --FInteractionBenchmarkCounters::ScopeDepth == 0)
+		{
+			FInteractionBenchmarkCounters::Cycles += FPlatformTime::Cycles64() - StartCycles;
+		}
+	}
+};
+
+#define INTERACTION_BENCHMARK_SCOPE() FInteractionBenchmarkScope PREPROCESSOR_JOIN(InteractionBenchmarkScope, __LINE__)
+
+#define INTERACTION_INC_TRACES() \
+	do { INC_DWORD_STAT(STAT_InteractionTraces); ++FInteractionBenchmarkCounters::Traces; } while (0)
+
+#define INTERACTION_INC_CREATED_WIDGETS() \
+	do { INC_DWORD_STAT(STAT_InteractionCreateWidget); ++FInteractionBenchmarkCounters::CreatedWidgets; } while (0)
+
+#else
+
+#define INTERACTION_BENCHMARK_SCOPE()
+
+#define INTERACTION_INC_TRACES() do { } while (0)
+
+#define INTERACTION_INC_CREATED_WIDGETS() do { } while (0)
+
+#endif //!UE_BUILD_SHIPPING
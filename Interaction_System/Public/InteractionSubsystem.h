@@ -0,0 +1,609 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "InteractionSpatialGrid.h"
+#include "InteractionLightweight.h"
+#include "InteractionLatency.h"
+#include "InteractionReplay.h"
+#include "InteractionEvaluation.h"
+#include "InteractionEvents.h"
+
+#include "InteractionSubsystem.generated.h"
+
+class UInteractableComponent;
+class UPlayerInteractionComponent;
+class UInteractableDefinition;
+class UInteractionSubsystem;
+class UInstancedStaticMeshComponent;
+class ULevel;
+class UCanvas;
+class APlayerController;
+struct FInteractable;
+struct FInteractionMemoryReport;
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FInteractionLightweightNativeDelegate, FInteractionHandle,
+	UPlayerInteractionComponent*);
+DECLARE_MULTICAST_DELEGATE_OneParam(FInteractionLightweightUsedDelegate, FInteractionHandle);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInteractionLightweightDelegate, FInteractionHandle, Handle,
+	AActor*, Player);
+
+UENUM(BlueprintType)
+enum class EInteractionRejectReason : uint8
+{
+	NotUsable,
+	AlreadyClaimed
+};
+
+USTRUCT(BlueprintType)
+struct FInteractionQueueMetrics
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 LastQueueDepth = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 PeakQueueDepth = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	float LastProcessingTimeMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	float PeakProcessingTimeMs = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 ExecutedRequests = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Interaction")
+	int32 RejectedRequests = 0;
+};
+
+struct FInteractionRequest
+{
+	TWeakObjectPtr<UPlayerInteractionComponent> Player;
+
+	TWeakObjectPtr<UInteractableComponent> Interactable;
+
+	// Set instead of Interactable for lightweight interactables
+	FInteractionHandle LightweightHandle;
+
+	float ClientTimeStamp = 0.f;
+
+	// Platform times used by latency telemetry, ReceiveTime is only set for requests sent by a client
+	double ReceiveTime = 0.0;
+
+	double EnqueueTime = 0.0;
+};
+
+struct FInteractionGridEntry
+{
+	TWeakObjectPtr<UInteractableComponent> Component;
+};
+
+// Interaction components owned by an actor, first registered component of each class wins
+struct FInteractionActorComponents
+{
+	TWeakObjectPtr<UInteractableComponent> Interactable;
+
+	TWeakObjectPtr<UPlayerInteractionComponent> Player;
+};
+
+// Runs the batched selection pass once movement and physics are done, before the interaction components tick
+struct FInteractionEvaluationTickFunction : public FTickFunction
+{
+	UInteractionSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+		const FGraphEventRef& MyCompletionGraphEvent) override;
+
+	virtual FString DiagnosticMessage() override;
+};
+
+/*Per-world owner of the interaction state shared by every component. Interaction requests received from clients
+are queued here and executed once per frame in arrival order instead of inside the RPC dispatch. Also owns the
+registry of interaction components by actor, the static, dynamic and lightweight spatial grids with the server
+candidate tracking built on them, lightweight interactables, level streaming and initial overlap registration,
+the batched candidate evaluation, event coalescing, latency telemetry, record and replay, the debug overlay and
+memory reports. Each of them has its own region below.*/
+UCLASS()
+class INTERACTIONSYSTEM_API UInteractionSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+private:
+
+	TArray<FInteractionRequest> PendingRequests;
+
+	TArray<FInteractionRequest> ProcessingRequests;
+
+	// Interactables already used by a request in the batch being processed
+	TSet<const UInteractableComponent*> ClaimedInteractables;
+
+	FInteractionQueueMetrics QueueMetrics;
+
+	// Interactables registered on the server, used to track which interactables are in range of each player
+	TInteractionSpatialGrid<FInteractionGridEntry> SpatialGrid;
+
+	/*Interactables that moved after registration. Kept apart from SpatialGrid so moving entries never
+	re-bucket static ones or widen their queries with a larger MaxRadius.*/
+	TInteractionSpatialGrid<FInteractionGridEntry> DynamicGrid;
+
+	// Dynamic interactables moved since the last flush, each listed once
+	TArray<TWeakObjectPtr<UInteractableComponent>> MovedInteractables;
+
+	TArray<TWeakObjectPtr<UPlayerInteractionComponent>> TrackedPlayers;
+
+	// Bit per player index handed out by AllocatePlayerIndex
+	uint64 UsedPlayerIndices = 0;
+
+	// Replaces FindComponentByClass in hot paths, filled when components are registered
+	TMap<TObjectKey<AActor>, FInteractionActorComponents> ActorComponents;
+
+	FInteractionLightweightStore LightweightStore;
+
+	// Lightweight interactables on every net mode, each with the reach of its definition
+	TInteractionSpatialGrid<FInteractionHandle> LightweightGrid;
+
+	UPROPERTY()
+	TArray<UInteractableDefinition*> LightweightDefinitions;
+
+	// Lightweight interactables already used by a request in the batch being processed
+	TSet<FInteractionHandle> ClaimedLightweight;
+
+	bool bInitialized = false;
+
+	void ProcessInteractionRequests();
+
+	void UpdateServerCandidates();
+
+	// Writes the latest location of every moved interactable into DynamicGrid
+	void FlushMovedInteractables();
+
+	// Returns false if the request was rejected
+	bool ProcessLightweightRequest(const FInteractionRequest& Request, UPlayerInteractionComponent* Player);
+
+public:
+
+	static bool IsServerCandidateTrackingEnabled();
+
+	static UInteractionSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	// ReceiveTime is the platform time the client request arrived, the client is sent a confirmation if set
+	void EnqueueInteraction(UPlayerInteractionComponent* Player, UInteractableComponent* Interactable,
+		float ClientTimeStamp, double ReceiveTime = 0.0);
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	FInteractionQueueMetrics GetQueueMetrics() const
+	{
+		return QueueMetrics;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void ResetQueueMetrics();
+
+	void RegisterInteractable(UInteractableComponent* Interactable);
+
+	void UnregisterInteractable(UInteractableComponent* Interactable);
+
+	/*Called from the transform updated callback of registered interactables. The first move promotes the
+	interactable to the dynamic tier, later moves are coalesced and applied once per frame.*/
+	void NotifyInteractableMoved(UInteractableComponent* Interactable);
+
+	void RegisterPlayer(UPlayerInteractionComponent* Player);
+
+	void UnregisterPlayer(UPlayerInteractionComponent* Player);
+
+	// Returns a free index in [0, 64) or INDEX_NONE if every index is taken
+	int32 AllocatePlayerIndex();
+
+	void ReleasePlayerIndex(int32 PlayerIndex);
+
+#pragma region Component Registry
+
+public:
+
+	static bool IsComponentRegistryEnabled();
+
+	void RegisterComponent(UInteractableComponent* Component);
+
+	void UnregisterComponent(UInteractableComponent* Component);
+
+	void RegisterComponent(UPlayerInteractionComponent* Component);
+
+	void UnregisterComponent(UPlayerInteractionComponent* Component);
+
+	// Cached lookups, fall back to FindComponentByClass when the registry is disabled or unavailable
+	static UInteractableComponent* FindInteractableComponent(const AActor* Actor);
+
+	static UPlayerInteractionComponent* FindPlayerInteractionComponent(const AActor* Actor);
+
+#pragma endregion
+
+#pragma region Level Streaming
+
+private:
+
+	// Every player component of the world, tracked players are limited to the server
+	TArray<TWeakObjectPtr<UPlayerInteractionComponent>> RegisteredPlayers;
+
+	TArray<TWeakObjectPtr<UInteractableComponent>> StreamedInInteractables;
+
+	TArray<TWeakObjectPtr<UInteractableComponent>> StreamedOutInteractables;
+
+	FDelegateHandle LevelAddedHandle;
+
+	FDelegateHandle LevelRemovedHandle;
+
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	// Registers the queued interactables in one pass and queues their initial overlap check
+	void FlushStreamedInInteractables();
+
+	// Unregisters the queued interactables and removes them from every player in one pass
+	void FlushStreamedOutInteractables();
+
+public:
+
+	// True for components of actors placed in a streamed level or World Partition cell
+	static bool IsInStreamedLevel(const UActorComponent* Component);
+
+	/*Interactables of streamed levels skip their own registration and initial overlap check, they are
+	handled in bulk when the level finished streaming in or out.*/
+	void QueueStreamedInInteractable(UInteractableComponent* Interactable);
+
+	void QueueStreamedOutInteractable(UInteractableComponent* Interactable);
+
+#pragma endregion
+
+#pragma region Initial Overlaps
+
+private:
+
+	struct FPendingOverlapCheck
+	{
+		TWeakObjectPtr<UInteractableComponent> Interactable;
+
+		float DueTime = 0.f;
+
+		bool operator<(const FPendingOverlapCheck& Other) const
+		{
+			return DueTime < Other.DueTime;
+		}
+	};
+
+	/*Min heap by due time since checks are queued with different delays, checks that don't fit into the frame
+	budget stay for the next frame.*/
+	TArray<FPendingOverlapCheck> PendingOverlapChecks;
+
+	void ResolveInitialOverlaps();
+
+public:
+
+	/*Adds Interactable to every local player already inside its sphere once Delay passed, a negative Delay uses
+	Interaction.InitialOverlapDelay. Replaces a timer per component, all checks due in a frame share one pass
+	spread over frames by Interaction.InitialOverlapBudgetMs.*/
+	void QueueInitialOverlapCheck(UInteractableComponent* Interactable, float Delay);
+
+#pragma endregion
+
+#pragma region Debug Overlay
+
+private:
+
+	FDelegateHandle DebugDrawHandle;
+
+	// Registered with UDebugDrawService, draws the cached evaluation results of the viewport's player
+	void DrawDebugOverlay(UCanvas* Canvas, APlayerController* PlayerController);
+
+public:
+
+	static bool IsDebugOverlayEnabled();
+
+#pragma endregion
+
+#pragma region Latency Telemetry
+
+private:
+
+	FInteractionLatencyHistogram LatencyHistograms[static_cast<int32>(EInteractionLatencyStage::MAX)];
+
+public:
+
+	static bool IsLatencyTelemetryEnabled();
+
+	/*Adds a sample to the histogram of Stage and publishes the stage's percentiles to stat InteractionLatency.
+	Raw samples go to the InteractionLatency CSV profiler category.*/
+	void RecordLatency(EInteractionLatencyStage Stage, float Milliseconds);
+
+	const FInteractionLatencyHistogram& GetLatencyHistogram(EInteractionLatencyStage Stage) const;
+
+	// Fraction in [0, 1], e.g. 0.95 for p95
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	float GetLatencyPercentile(EInteractionLatencyStage Stage, float Fraction) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void ResetLatencyHistograms();
+
+#pragma endregion
+
+#pragma region Record and Replay
+
+private:
+
+	FInteractionReplay Recording;
+
+	FInteractionReplay Replay;
+
+	FString RecordingFilename;
+
+	// Players of the recording or replay, index i plays the recorded player i
+	TArray<TWeakObjectPtr<UPlayerInteractionComponent>> ReplayPlayers;
+
+	// Inputs of each player in ReplayPlayers since the last recorded frame
+	TArray<TArray<EInteractionReplayInput, TInlineAllocator<2>>> PendingReplayInputs;
+
+	int32 ReplayFrame = 0;
+
+	// Hash of the interactable selected by every player in every replayed frame, equal for equal replays
+	uint32 ReplaySelectionChecksum = 0;
+
+	int32 RandomSeed = 0;
+
+	bool bUseRandomSeed = false;
+
+	bool bRecording = false;
+
+	bool bReplaying = false;
+
+	bool bPreviousUseFixedTimeStep = false;
+
+	double PreviousFixedDeltaTime = 0.0;
+
+	FDelegateHandle WorldTickStartHandle;
+
+	FDelegateHandle PostActorTickHandle;
+
+	// Locally controlled players with a pawn, sorted by pawn name so recordings and replays agree on the order
+	void GatherReplayPlayers();
+
+	void BindReplayDelegates();
+
+	void UnbindReplayDelegates();
+
+	// Stops the replayed pawns from moving by themselves or by the player's input while bDisabled
+	void SetReplayPlayersControlDisabled(bool bDisabled);
+
+	// Applies the next recorded frame before anything ticks
+	void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+
+	// Records the frame or folds the replayed selection into the checksum once every actor ticked
+	void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaTime);
+
+public:
+
+	/*Seeds every randomized interactable value. Each interactable uses its own stream seeded from Seed and its
+	path so the values don't depend on the BeginPlay order, interactables which already began play are
+	randomized again.*/
+	void SetRandomSeed(int32 Seed);
+
+	// Returns false without a random seed, callers fall back to FMath::RandRange
+	bool GetRandomStream(const UObject* Object, FRandomStream& OutStream) const;
+
+	/*Records transforms, control rotations and interaction inputs of the locally controlled players every frame
+	until StopRecording writes them to Filename. Randomized values are seeded for the recording.*/
+	void StartRecording(const FString& Filename);
+
+	void StopRecording();
+
+	/*Feeds a recording back to the local players with the recorded random seed and frame times. Movement
+	components of the replayed pawns and the input of their controllers are disabled until the replay ends.*/
+	bool StartReplay(const FString& Filename);
+
+	void StopReplay();
+
+	bool IsRecording() const
+	{
+		return bRecording;
+	}
+
+	bool IsReplaying() const
+	{
+		return bReplaying;
+	}
+
+	// Called by UPlayerInteractionComponent for the interaction functions called by the game
+	void RecordReplayInput(const UPlayerInteractionComponent* Player, EInteractionReplayInput Input);
+
+#pragma endregion
+
+#pragma region Parallel Evaluation
+
+private:
+
+	struct FEvaluationBatchEntry
+	{
+		UPlayerInteractionComponent* Player = nullptr;
+
+		// INDEX_NONE if the player had nothing to evaluate
+		int32 ViewIndex = INDEX_NONE;
+
+		int32 FirstJob = 0;
+
+		int32 NumJobs = 0;
+	};
+
+	// Scratch arrays of EvaluateSelections, kept between frames so batches don't allocate
+	TArray<FInteractionEvaluationView> EvaluationViews;
+
+	TArray<FInteractionEvaluationJob> EvaluationJobs;
+
+	TArray<FEvaluationBatchEntry> EvaluationBatch;
+
+	friend struct FInteractionEvaluationTickFunction;
+
+	// Ticks in TG_PostPhysics, the tick of every registered interaction component depends on it
+	FInteractionEvaluationTickFunction EvaluationTickFunction;
+
+	// Evaluates every player whose selection was used last frame, with this frame's transforms
+	void EvaluateUsedSelections();
+
+	// Makes ComponentTick run after the evaluation batch of every frame
+	void AddEvaluationPrerequisite(FTickFunction& ComponentTick);
+
+	void RemoveEvaluationPrerequisite(FTickFunction& ComponentTick);
+
+public:
+
+	static bool IsParallelEvaluationEnabled();
+
+	/*Selection pass of Players in three phases. Gather snapshots the players and their candidates on the game
+	thread, evaluate runs the distance, reachability and angle checks of every candidate on the task graph and
+	apply scores, selects and updates LastEvaluation on the game thread. Selection delegates are broadcasted
+	once the whole batch is applied.*/
+	void EvaluateSelections(TArrayView<UPlayerInteractionComponent* const> Players);
+
+#pragma endregion
+
+#pragma region Events
+
+private:
+
+	FInteractionEventQueue EventQueue;
+
+public:
+
+	static bool IsEventDeferralEnabled();
+
+	/*Queues the event until the end of the frame so listeners run after the evaluation instead of inside it.
+	Broadcasted right away outside of game worlds or with Interaction.DeferredEvents 0.*/
+	static void BroadcastEvent(EInteractionEvent Event, UInteractableComponent* Interactable,
+		UPlayerInteractionComponent* Player);
+
+	// Broadcasts the queued events, called last by Tick
+	void FlushEvents();
+
+#pragma endregion
+
+#pragma region Memory
+
+public:
+
+	/*Fills Report with every interaction component, widget and cache of this world, used by
+	Interaction.DumpMemory and memreport.*/
+	void GatherMemoryReport(FInteractionMemoryReport& Report) const;
+
+	// Containers owned by the subsystem itself
+	void AddMemoryUsage(FInteractionMemoryReport& Report) const;
+
+#pragma endregion
+
+#pragma region Lightweight Interactables
+
+public:
+
+	UPROPERTY(BlueprintAssignable, Category = "InteractionDelegates")
+	FInteractionLightweightDelegate OnLightweightInteractedDelegate;
+
+	FInteractionLightweightNativeDelegate OnLightweightInteracted;
+
+	// Broadcasted on every machine when an interactable was used up by bDisableAfterUsage
+	FInteractionLightweightUsedDelegate OnLightweightUsed;
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	FInteractionHandle AddLightweightInteractable(UInteractableDefinition* Definition, FVector Location);
+
+	// Lightweight interactable represented by an instance of InstanceComponent
+	FInteractionHandle AddInstancedLightweightInteractable(UInteractableDefinition* Definition,
+		const FVector& Location, UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex);
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void RemoveLightweightInteractable(FInteractionHandle Handle);
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void SetLightweightInteractableEnabled(FInteractionHandle Handle, bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	bool IsLightweightInteractableValid(FInteractionHandle Handle) const
+	{
+		return LightweightStore.IsValid(Handle);
+	}
+
+	// Valid, enabled and not used up
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	bool IsLightweightInteractableUsable(FInteractionHandle Handle) const;
+
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	FVector GetLightweightLocation(FInteractionHandle Handle) const;
+
+	const FInteractable* GetLightweightSettings(const FInteractionHandle& Handle) const;
+
+	UInstancedStaticMeshComponent* GetLightweightInstance(const FInteractionHandle& Handle,
+		int32& OutInstanceIndex) const;
+
+	/*Handle of this machine for an interactable received over the network. Instances are identified by their
+	net addressable mesh and instance index since handles come from each machine's free list, Handle is only
+	used for lightweight interactables without an instance.*/
+	FInteractionHandle ResolveLightweightInstance(const FInteractionHandle& Handle,
+		const UInstancedStaticMeshComponent* InstanceComponent, int32 InstanceIndex) const;
+
+	// Keeps the handle pointing at its instance after instances of the backing component were reordered
+	void SetLightweightInstanceIndex(const FInteractionHandle& Handle, int32 InstanceIndex);
+
+	int32 GetNumLightweightInteractables() const
+	{
+		return LightweightStore.Num();
+	}
+
+	// Calls Func(Handle) for every lightweight interactable whose reach overlaps the sphere at Location
+	template<typename FuncType>
+	void QueryLightweightInteractables(const FVector& Location, float Radius, FuncType&& Func) const
+	{
+		LightweightGrid.Query(Location, Radius, [&Func](int32 ElementIndex, const FInteractionHandle& Handle)
+		{
+			Func(Handle);
+		});
+	}
+
+	void EnqueueLightweightInteraction(UPlayerInteractionComponent* Player, const FInteractionHandle& Handle,
+		float ClientTimeStamp);
+
+	// Interacts without validation, used directly when playing offline and by the request queue
+	void ExecuteLightweightInteraction(UPlayerInteractionComponent* Player, const FInteractionHandle& Handle);
+
+	// Applies bDisableAfterUsage on this machine, hiding the backing instance
+	void MarkLightweightUsed(const FInteractionHandle& Handle);
+
+#pragma endregion
+
+#pragma region Tickable
+
+public:
+
+	virtual void Tick(float DeltaTime) override;
+
+	virtual bool IsTickable() const override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual UWorld* GetTickableGameObjectWorld() const override
+	{
+		return GetWorld();
+	}
+
+#pragma endregion
+
+};
@@ -0,0 +1,46 @@
+// Copyright Andrzej Serazetdinow, 2020 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#define INTERACTION_TRACE_ENABLED (UE_TRACE_ENABLED && !UE_BUILD_SHIPPING)
+
+enum class EInteractionTraceEvent : uint8
+{
+	Subscribe,
+	Unsubscribe,
+	SelectionChanged,
+	WidgetCreated,
+	ServerRPCSent,
+	ServerRPCReceived,
+	Interact
+};
+
+#if INTERACTION_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(InteractionChannel, INTERACTIONSYSTEM_API);
+
+/*Interaction events for Unreal Insights, enabled with -trace=cpu,InteractionChannel (or "Trace.Enable
+InteractionChannel"). Every event carries the unique ids of the interactable and player objects, either may be
+0 when it doesn't apply. CPU scopes of the channel show up in the timing view next to physics and GC.*/
+struct INTERACTIONSYSTEM_API FInteractionTrace
+{
+	static void OutputEvent(EInteractionTraceEvent Type, const UObject* Interactable, const UObject* Player);
+};
+
+#define TRACE_INTERACTION_EVENT(Event, Interactable, Player) \
+	FInteractionTrace::OutputEvent(EInteractionTraceEvent::Event, Interactable, Player)
+
+#define TRACE_INTERACTION_SCOPE(Name) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(#Name, InteractionChannel)
+
+#else
+
+#define TRACE_INTERACTION_EVENT(Event, Interactable, Player)
+
+#define TRACE_INTERACTION_SCOPE(Name)
+
+#endif //INTERACTION_TRACE_ENABLED
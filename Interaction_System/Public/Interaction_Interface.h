@@ -21,9 +21,9 @@ class INTERACTIONSYSTEM_API IInteractionInterface
 
 public:
 
-	virtual uint8 GetPriority() const
+	virtual int32 GetPriority() const
 	{
-		return 0u;
+		return 0;
 	}
 
 	virtual bool CanInteract(const AActor* Player)
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "InteractionHistory.h"
+#include "InteractionEvaluation.h"
+#include "InteractionEvents.h"
+#include "InteractionSubsystem.h"
 #include "PlayerInteractionComponent.generated.h"
 
 class UInteractableComponent;
@@ -13,7 +17,10 @@ class UInteractionWidgetOnInteractable;
 class UInteractableWidget;
 
 class UArrowComponent;
+class UInstancedStaticMeshComponent;
 class UUserWidget;
+class UCanvas;
+struct FInteractionMemoryReport;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDynamicMulticastDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDynamicMulticastDelegateOP_I, AActor*, Interactable);
@@ -47,14 +54,120 @@ public:
 	bool bDrawDebugStringsByDefault = true;
 };
 
+struct FInteractionCandidate
+{
+	TWeakObjectPtr<UInteractableComponent> Component;
+
+	int32 Priority = 0;
+
+	float DistanceSquared = 0.f;
+
+	uint32 InsertionOrder = 0;
+
+	// Index into SelectionData of the last selection pass, only kept up to date in CandidateKeys
+	int32 SelectionIndex = INDEX_NONE;
+};
+
+// Weights of the terms used to score candidates, every term is normalized to [0, 1] before weighting
+USTRUCT(BlueprintType)
+struct FInteractionScoreWeights
+{
+	GENERATED_USTRUCT_BODY()
+
+public:
+
+	// Higher priority scores higher, or lower priority if bUseLowerPriorityFirst is set
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction|Selection")
+	float Priority = 1.f;
+
+	// Closer interactables score higher
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction|Selection")
+	float Distance = 0.f;
+
+	// Interactables closer to the player's view direction score higher
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction|Selection")
+	float ViewAngle = 0.f;
+
+	// Higher rarity scores higher
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction|Selection")
+	float Rarity = 0.f;
+};
+
+// Per candidate results of the selection pass, kept as separate arrays parallel to ActorsToInteract
+struct FInteractionSelectionData
+{
+	TArray<float, TInlineAllocator<16>> Priorities;
+
+	TArray<float, TInlineAllocator<16>> Distances;
+
+	TArray<float, TInlineAllocator<16>> ViewDots;
+
+	TArray<float, TInlineAllocator<16>> Rarities;
+
+	TArray<float, TInlineAllocator<16>> Scores;
+
+	TArray<bool, TInlineAllocator<16>> Usable;
+
+	// Known for every enabled candidate, shows the interaction marker without tracing again
+	TArray<bool, TInlineAllocator<16>> Reachable;
+
+	void SetNum(int32 Num)
+	{
+		Priorities.SetNumUninitialized(Num, false);
+		Distances.SetNumUninitialized(Num, false);
+		ViewDots.SetNumUninitialized(Num, false);
+		Rarities.SetNumUninitialized(Num, false);
+		Scores.SetNumUninitialized(Num, false);
+		Usable.SetNumUninitialized(Num, false);
+		Reachable.SetNumUninitialized(Num, false);
+	}
+};
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent), Blueprintable)
 class INTERACTIONSYSTEM_API UPlayerInteractionComponent final : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UInteractionSubsystem;
+
 private:
 
-	TArray<TWeakObjectPtr<UInteractableComponent>> ActorsToInteract;
+	// Candidates ordered by priority, then distance at insertion, then insertion order
+	TArray<FInteractionCandidate, TInlineAllocator<16>> ActorsToInteract;
+
+	// Sort key of every candidate, used for O(1) membership and O(log n) lookup inside ActorsToInteract
+	TMap<TObjectKey<UInteractableComponent>, FInteractionCandidate, TInlineSetAllocator<16>> CandidateKeys;
+
+	uint32 NextCandidateInsertionOrder = 0;
+
+	TWeakObjectPtr<UArrowComponent> PlayerArrow;
+
+	FInteractionSelectionData SelectionData;
+
+	// Winner of the last selection pass
+	TWeakObjectPtr<UInteractableComponent> ScoredCandidate;
+
+	uint64 SelectionFrame = 0;
+
+	// Set when ActorsToInteract changed since the last selection pass
+	bool bSelectionDirty = true;
+
+	// Every assignment of InteractableInteracted goes through here so the trace channel sees each change
+	void SetInteractableInteracted(UInteractableComponent* Component);
+
+	// Lightweight interactables in reach, refreshed by UpdateLightweightCandidates
+	TArray<FInteractionHandle, TInlineAllocator<8>> LightweightCandidates;
+
+	FInteractionHandle SelectedLightweight;
+
+	FTimerHandle LightweightDiscoveryTimerHandle;
+
+	bool bShowingLightweightWidget = false;
+
+	bool bCandidatesSortedByLowerPriority = false;
+
+	// Small per-world index of this player used by interactables for their subscription bitmask
+	int32 InteractionIndex = INDEX_NONE;
 
 	// Name widget container
 	TWeakObjectPtr<UNameWidget> InteractionWidgetName;
@@ -77,17 +190,55 @@ private:
 	// Player Controller container
 	TWeakObjectPtr<APlayerController> PC;
 
-	float CurrentTimeInSecondsForButtonHold;
+	// Server-side history of pawn transforms and view rotations used for lag compensated validation
+	TInteractionHistoryBuffer<64> PositionHistory;
+
+	// Viewport size and field of view of the owning client, the server projects first person angles with them
+	FIntPoint ClientViewSize = FIntPoint::ZeroValue;
+
+	float ClientFieldOfView = 90.f;
+
+	// Sends the local view to the server when it changed, polled on a timer and before every interaction request
+	void UpdateClientView();
+
+	FTimerHandle ClientViewTimerHandle;
+
+	FTimerHandle HistoryTimerHandle;
+
+	// Times the hold on the machine which executes the interaction, the server for online interactions
+	FTimerHandle HoldTimerHandle;
+
+	// Interactable held on the machine which times the hold
+	TWeakObjectPtr<UInteractableComponent> HeldInteractable;
+
+	// Server time at which the current hold started, used by the client to interpolate the progress widget
+	float HoldStartTime;
 
 	bool IsInteracting : 1;
 
 	bool IsOnlineInteracting : 1;
 
+	// Client waits for or has a hold timed by the server
+	bool IsHoldingOnServer : 1;
+
+	// Server times the hold on behalf of the owning client
+	bool IsHoldTimedForClient : 1;
+
 public:
 
 	// Interactable currently interacted
 	TWeakObjectPtr<UInteractableComponent> InteractableInteracted;
 
+	// Interactables in range of this player tracked by the server, value is the last server time in range
+	TMap<TObjectKey<UInteractableComponent>, float> ServerCandidates;
+
+	float ServerCandidatesUpdateTime = 0.f;
+
+	// Interaction RPCs received from and sent to the owning client, counted on the server
+	uint32 ServerRPCCount = 0;
+
+	uint32 ClientRPCCount = 0;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Interaction Debug")
 	FDebugStringProperties DSProperties;
 
@@ -122,6 +273,22 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Interaction")
 	bool CanSelectOnlyOneInteractable = true;
 
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Interaction|Selection")
+	FInteractionScoreWeights SelectionWeights;
+
+	/*Score margin another candidate needs over the selected interactable to replace it,
+	prevents the selection from flipping between candidates with nearly equal scores.*/
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.0"), Category = "Interaction|Selection")
+	float SelectionHysteresis = 0.05f;
+
+	// How often the locally controlled player looks for lightweight interactables around it
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.01"), Category = "Interaction|Lightweight")
+	float LightweightDiscoveryInterval = 0.1f;
+
+	// How often an owning client in first person mode checks its viewport size and field of view for the server
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (ClampMin = "0.01"), Category = "Interaction")
+	float ClientViewUpdateInterval = 0.25f;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Interaction")
 	bool bShowOnlyOneInteractableName = false;
 
@@ -146,6 +313,19 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Interaction")
 	bool bRotateWidgetsTowardsPlayerPawn = false;
 
+	/*If true the server validates interactions against where the player was when the client sent the request
+	instead of where the player is when the request arrives.*/
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Interaction|Lag Compensation")
+	bool bUseLagCompensation = true;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bUseLagCompensation", ClampMin = "0.0"),
+		Category = "Interaction|Lag Compensation")
+	float MaximumRewindTime = 0.5f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, meta = (EditCondition = "bUseLagCompensation", ClampMin = "0.005"),
+		Category = "Interaction|Lag Compensation")
+	float HistorySampleInterval = 1.f / 30.f;
+
 private:
 
 	UPlayerInteractionComponent();
@@ -155,14 +335,116 @@ private:
 	// Set a player controller to show widgets on certain player's HUD
 	void SetPC();
 
+	void OnRegister() override;
+
+	void OnUnregister() override;
+
 	void BeginPlay() override;
 
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	void SortActors();
 
+	bool IsCandidateBefore(const FInteractionCandidate& LHS, const FInteractionCandidate& RHS) const;
+
+	void InsertCandidate(UInteractableComponent* Component);
+
+	bool RemoveCandidate(const UInteractableComponent* Component);
+
+	void RecordHistorySample();
+
+	/*Selection pass split into phases by UInteractionSubsystem::EvaluateSelections. GatherSelection adds a view
+	and a job per candidate, ApplySelection reads the evaluated jobs back and returns true if InteractableInteracted
+	changed. The change is broadcasted by BroadcastSelection once every player of the batch is applied.*/
+	void GatherSelection(TArray<FInteractionEvaluationView>& Views, TArray<FInteractionEvaluationJob>& Jobs);
+
+	bool ApplySelection(TArrayView<const FInteractionEvaluationJob> Jobs, const FInteractionEvaluationView* View);
+
+	// Index of Component into SelectionData after UpdateSelection, INDEX_NONE if it isn't a candidate, O(1)
+	int32 FindSelectionIndex(const UInteractableComponent* Component) const;
+
+	void BroadcastSelection();
+
+	FInteractionPlayerSnapshot MakeSnapshot() const;
+
+	bool ValidateInteractionAtTime(UInteractableComponent* Component, float ClientTimeStamp) const;
+
+	// StopInteraction without recording it as an input of the game, used by the component itself
+	void StopInteractionInternal();
+
 	void TryExecuteInteract(const TWeakObjectPtr<UInteractableComponent>& Actor);
 
 	void ExecuteInteract(const TWeakObjectPtr<UInteractableComponent>& Actor);
 
+	void StartHold(UInteractableComponent* Component);
+
+	void BeginHoldTimer(UInteractableComponent* Component, float StartTime);
+
+	void ClearHoldTimer();
+
+	void OnHoldTimerCompleted();
+
+	void UpdateLightweightCandidates();
+
+	bool CanInteractWithLightweight(const UInteractionSubsystem& Subsystem, const FInteractionHandle& Handle,
+		const FVector& ViewLocation, const FVector& ViewDirection) const;
+
+	bool ValidateLightweightAtTime(const FInteractionHandle& Handle, float ClientTimeStamp) const;
+
+	// Returns true if a lightweight interactable was used instead of an interactable component
+	bool TryInteractWithLightweight(bool bOnline);
+
+#pragma region Latency Telemetry
+
+private:
+
+	// Request sent to the server and waiting for InteractionConfirmedOn_Client, platform times
+	struct FPendingLatencySample
+	{
+		double InputTime = 0.0;
+
+		double SendTime = 0.0;
+
+		double ExpiryTime = 0.0;
+
+		float HoldSeconds = 0.f;
+	};
+
+	TMap<TWeakObjectPtr<UInteractableComponent>, FPendingLatencySample> PendingLatencySamples;
+
+	// Platform time the frame of the last interaction input started at, 0 while latency telemetry is disabled
+	double InteractionInputTime = 0.0;
+
+	// Platform time the hold timer would have started at without any latency, 0 once its overshoot was recorded
+	double HoldTimerStartTime = 0.0;
+
+	// Server side, platform time the hold request of the owning client arrived
+	double HoldReceiveTime = 0.0;
+
+	bool bInputLatencyRecorded = false;
+
+	// Timestamps the input with the start of its frame if Interaction.LatencyTelemetry is enabled
+	void BeginLatencySample();
+
+	// Records the Input stage once per input
+	void RecordInputLatency();
+
+	// Records the Input stage and keeps the send time until the server confirms the interaction
+	void TrackSentRequest(UInteractableComponent* Component, float HoldSeconds);
+
+	// Records the Total stage of an interaction executed on this machine, the hold duration is excluded
+	void RecordLocalTotalLatency(float HoldSeconds);
+
+	UFUNCTION(Client, Unreliable)
+	void InteractionConfirmedOn_Client(UInteractableComponent* Interactable, float ServerTimeMs);
+
+public:
+
+	// Server side, sends the time the request spent on the server since ReceiveTime back to the owning client
+	void ConfirmInteraction(UInteractableComponent* Interactable, double ReceiveTime);
+
+#pragma endregion
+
 #pragma region Interactable Name
 
 private:
@@ -257,14 +539,131 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "InteractionDelegates")
 	FDynamicMulticastDelegate OnNoInteractablesLeftDelegate;
 
+	// Broadcasted when the selection pass picked a different interactable
+	UPROPERTY(BlueprintAssignable, Category = "InteractionDelegates")
+	FDynamicMulticastDelegateOP_I OnInteractableSelectedDelegate;
+
+	// Broadcasted on the owning client when the server refused an interaction request
+	UPROPERTY(BlueprintAssignable, Category = "InteractionDelegates")
+	FDynamicMulticastDelegateOP_I OnInteractionRejectedDelegate;
+
+	// Native variants, broadcasted right before their dynamic delegate by the subsystem's event queue
+	FInteractionNativeDelegate OnInteractableSubscribed;
+
+	FInteractionNativeDelegate OnInteractableUnsubscribed;
+
+	FInteractionNativeDelegate OnFirstInteractableSubscribed;
+
+	FInteractionNativeDelegate OnCanInteract;
+
+	FInteractionPlayerNativeDelegate OnNoInteractablesLeft;
+
+	FInteractionNativeDelegate OnInteractableSelected;
+
 #pragma endregion
 
 public:
 
 	UFUNCTION(Server, Reliable, WithValidation)
-	void InteractWithInteractablesOn_Server   (UInteractableComponent* ActorToInteract);
+	void InteractWithInteractablesOn_Server(UInteractableComponent* ActorToInteract, float ClientTimeStamp);
+
+	// Time in seconds synchronized with the server, used to timestamp requests sent to the server
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	float GetServerWorldTime() const;
+
+	// Returns the rewound player state at TimeStamp, only available on the server
+	bool GetSnapshotAtTime(float TimeStamp, FInteractionPlayerSnapshot& OutSnapshot) const;
+
+	int32 GetInteractionIndex() const
+	{
+		return InteractionIndex;
+	}
+
+	// Reorders the interactable after its priority changed, O(log n) search
+	void OnInteractablePriorityChanged(UInteractableComponent* Component);
+
+	// Highest ordered candidate, O(1)
+	UInteractableComponent* GetBestCandidate() const;
+
+	/*Lightweight interactable used when no interactable component is in reach, its interaction text is shown
+	in the interaction widget. Holding is not supported, lightweight interactables are used on press.*/
+	UFUNCTION(BlueprintPure, Category = "Interaction")
+	FInteractionHandle GetSelectedLightweight() const
+	{
+		return SelectedLightweight;
+	}
+
+	// Instances are sent as their mesh and instance index and resolved on the receiving machine
+	UFUNCTION(Server, Reliable, WithValidation)
+	void InteractWithLightweightOn_Server(FInteractionHandle Handle, UInstancedStaticMeshComponent* InstanceComponent,
+		int32 InstanceIndex, float ClientTimeStamp);
+
+	UFUNCTION(Client, Reliable)
+	void LightweightUsedOn_Client(FInteractionHandle Handle, UInstancedStaticMeshComponent* InstanceComponent,
+		int32 InstanceIndex);
+
+	// Scores every candidate and publishes the winner, repeated calls in the same frame reuse the results
+	void UpdateSelection(bool bForce = false);
+
+	// CanInteract result of the current frame's selection pass
+	bool CanInteractCached(const UInteractableComponent* Component);
+
+	// Reachability found by the current frame's selection pass
+	bool IsReachableCached(const UInteractableComponent* Component);
+
+	/*State of this player read by the evaluation of its candidates. The first person angle is measured from the
+	first local player's view, bTraceLookAt traces what its camera looks at.*/
+	void GatherEvaluationView(FInteractionEvaluationView& OutView, bool bTraceLookAt) const;
+
+	/*First person view of the client at the time of Snapshot, projected like its viewport from the reported view
+	size and field of view. Returns false if the client hasn't reported its view yet.*/
+	bool GatherSnapshotView(const FInteractionPlayerSnapshot& Snapshot, FInteractionEvaluationView& OutView) const;
+
+	// Best scored usable candidate of the current frame
+	UInteractableComponent* GetScoredCandidate();
+
+	/*Draws every candidate with the results of its last evaluation and selection score as a table or as labels
+	next to the interactables, see Interaction.DebugOverlay. Nothing is evaluated again.*/
+	void DrawDebugOverlay(UCanvas* Canvas, bool bLabels) const;
+
+	// Adds this component, its widgets and its candidate containers to Report
+	void AddMemoryUsage(FInteractionMemoryReport& Report) const;
+
+	// First arrow of the owner, cached on BeginPlay and used as the player's forward direction
+	UArrowComponent* GetPlayerArrow() const
+	{
+		return PlayerArrow.Get();
+	}
+
+	// True if the interactable was in range of this player within the rewind window, only available on the server
+	bool IsServerCandidate(const UInteractableComponent* Component) const;
+
+	// Interactables currently in range of this player, only available on the server
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	TArray<UInteractableComponent*> GetServerCandidates() const;
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void StartHoldOn_Server(UInteractableComponent* ActorToInteract, float ClientTimeStamp);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void StopHoldOn_Server();
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void SetClientViewOn_Server(FIntPoint ViewSize, float FieldOfView);
 
-	// Used for button hold interaction to reset the CurrentTimeInSecondsForButtonHold variable
+	UFUNCTION(Client, Reliable)
+	void HoldStartedOn_Client(UInteractableComponent* ActorToInteract, float ServerStartTime);
+
+	UFUNCTION(Client, Reliable)
+	void HoldStoppedOn_Client();
+
+	UFUNCTION(Client, Reliable)
+	void InteractionRejectedOn_Client(UInteractableComponent* ActorToInteract, EInteractionRejectReason Reason);
+
+	// Server side, stops the hold on the rejected interactable and notifies the owning client
+	void RejectInteraction(UInteractableComponent* ActorToInteract, EInteractionRejectReason Reason);
+
+	// Used for button hold interaction to stop the hold, also on the server for online interactions
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
 	void StopInteraction();
 
@@ -283,6 +682,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
 	void RemoveActorToInteract(const AActor* Actor);
 
+	// Same as AddActorToInteract for a specific interactable, used when an actor owns several of them
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void AddInteractable(UInteractableComponent* Component);
+
+	UFUNCTION(BlueprintCallable, Category = "Interaction")
+	void RemoveInteractable(UInteractableComponent* Component);
+
+	// Removes every interactable in Components and every destroyed candidate in one pass, used by level streaming
+	void RemoveInteractables(const TSet<const UInteractableComponent*>& Components);
+
 	UFUNCTION(BlueprintCallable, Category = "Interaction")
 	void ChangeInteractionWidget(const TSubclassOf<UInteractableWidget>& WidgetClass);
 